@@ -18,8 +18,11 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
+#include <unistd.h>
 #include <time.h>
 #include <pthread.h>
+#include <sys/uio.h>
 #include "chan.h"
 #include "chanBlb.h"
 
@@ -36,6 +39,226 @@ chanBlb_tSize(
 
 /**********************************************************/
 
+struct blbRef { /* shared buffer */
+  void *(*ma)(void *, unsigned long);
+  void (*mf)(void *);
+  pthread_mutex_t m;
+  chanBlb_t *o;     /* adopted blob, else octets follow */
+  unsigned char *d; /* first octet */
+  unsigned int s;   /* octets */
+  unsigned int c;   /* references */
+  chanBlbRef_t r;   /* first reference */
+};
+
+chanBlbRef_t *
+chanBlbRefNew(
+  void *(*ma)(void *, unsigned long)
+ ,void (*mf)(void *)
+ ,unsigned int h
+ ,unsigned int l
+ ,unsigned int t
+){
+  struct blbRef *x;
+
+  if (!ma || !mf
+   || l > ~0U - h
+   || t > ~0U - h - l
+   || !(x = ma(0, sizeof (*x) + h + l + t)))
+    return (0);
+  if (pthread_mutex_init(&x->m, 0)) {
+    mf(x);
+    return (0);
+  }
+  x->ma = ma;
+  x->mf = mf;
+  x->o = 0;
+  x->d = (unsigned char *)(x + 1);
+  x->s = h + l + t;
+  x->c = 1;
+  x->r.l = l;
+  x->r.b = x->d + h;
+  x->r.opaque = x;
+  return (&x->r);
+}
+
+chanBlbRef_t *
+chanBlbRefBlb(
+  void *(*ma)(void *, unsigned long)
+ ,void (*mf)(void *)
+ ,chanBlb_t *b
+){
+  struct blbRef *x;
+
+  if (!ma || !mf || !b
+   || !(x = ma(0, sizeof (*x))))
+    return (0);
+  if (pthread_mutex_init(&x->m, 0)) {
+    mf(x);
+    return (0);
+  }
+  x->ma = ma;
+  x->mf = mf;
+  x->o = b;
+  x->d = b->b;
+  x->s = b->l;
+  x->c = 1;
+  x->r.l = b->l;
+  x->r.b = b->b;
+  x->r.opaque = x;
+  return (&x->r);
+}
+
+chanBlbRef_t *
+chanBlbRefSlc(
+  chanBlbRef_t *r
+ ,unsigned int o
+ ,unsigned int l
+){
+  struct blbRef *x;
+  chanBlbRef_t *n;
+
+  if (!r
+   || o > r->l
+   || l > r->l - o)
+    return (0);
+  x = r->opaque;
+  if (!(n = x->ma(0, sizeof (*n))))
+    return (0);
+  n->l = l;
+  n->b = r->b + o;
+  n->opaque = x;
+  pthread_mutex_lock(&x->m);
+  ++x->c;
+  pthread_mutex_unlock(&x->m);
+  return (n);
+}
+
+unsigned char *
+chanBlbRefGrow(
+  chanBlbRef_t *r
+ ,unsigned int h
+ ,unsigned int t
+){
+  struct blbRef *x;
+  unsigned char *b;
+
+  if (!r)
+    return (0);
+  x = r->opaque;
+  b = 0;
+  pthread_mutex_lock(&x->m);
+  if (x->c == 1
+   && (unsigned long)(r->b - x->d) >= h
+   && (unsigned long)(x->d + x->s - r->b - r->l) >= t) {
+    r->b -= h;
+    r->l += h + t;
+    b = r->b;
+  }
+  pthread_mutex_unlock(&x->m);
+  return (b);
+}
+
+void
+chanBlbRefFree(
+  chanBlbRef_t *r
+){
+  struct blbRef *x;
+  void (*f)(void *);
+  unsigned int c;
+
+  if (!r)
+    return;
+  x = r->opaque;
+  f = x->mf; /* x may be freed once the count is dropped */
+  pthread_mutex_lock(&x->m);
+  c = --x->c;
+  pthread_mutex_unlock(&x->m);
+  if (r != &x->r)
+    f(r);
+  if (c)
+    return;
+  pthread_mutex_destroy(&x->m);
+  if (x->o)
+    x->mf(x->o);
+  x->mf(x);
+}
+
+/**********************************************************/
+
+#ifndef FINGRACE
+#define FINGRACE 1800 /* seconds an egress (or a lone direction) may still run after its Channel is shut */
+#endif
+
+struct finCtx { /* a bridge's directions, the last out does finalClose() */
+  void (*mf)(void *);
+  void *f;
+  void (*fc)(void *);
+  chan_t *cE;         /* egress, for ingress to wait on */
+  chan_t *cI;         /* ingress, for egress to wait on */
+  pthread_t tE;       /* egress thread */
+  pthread_t tI;       /* ingress thread */
+  pthread_mutex_t m;
+  pthread_cond_t v;   /* a direction's thread exited */
+  unsigned int n;     /* references, a thread per direction, a lone direction's watch and chanBlb() */
+  int xE;             /* egress thread running */
+  int xI;             /* ingress thread running */
+};
+
+static void
+finRel(
+  struct finCtx *v
+){
+  unsigned int n;
+
+  pthread_mutex_lock(&v->m);
+  n = --v->n;
+  pthread_mutex_unlock(&v->m);
+  if (n)
+    return;
+  pthread_cond_destroy(&v->v);
+  pthread_mutex_destroy(&v->m);
+  chanClose(v->cE);
+  chanClose(v->cI);
+  if (v->fc)
+    v->fc(v->f);
+  v->mf(v);
+}
+
+/* after Channel c is shut, wait up to FINGRACE for a direction's thread t (running while *x) to exit, else cancel it */
+static void
+finGrace(
+  struct finCtx *f
+ ,chan_t *c
+ ,int *x
+ ,pthread_t *t
+){
+  struct timespec ts;
+
+  chanOp(0, c, 0, chanOpSht);
+  clock_gettime(CLOCK_REALTIME, &ts);
+  ts.tv_sec += FINGRACE;
+  pthread_mutex_lock(&f->m);
+  while (*x && !pthread_cond_timedwait(&f->v, &f->m, &ts));
+  if (*x)
+    pthread_cancel(*t);
+  pthread_mutex_unlock(&f->m);
+}
+
+/* a lone direction has no other to cancel it, so it is watched */
+static void *
+finW(
+  void *v
+){
+#define V ((struct finCtx *)v)
+  if (V->cE)
+    finGrace(v, V->cE, &V->xE, &V->tE);
+  else
+    finGrace(v, V->cI, &V->xI, &V->tI);
+  finRel(v);
+  return (0);
+#undef V
+}
+
 struct ctxE { /* struct chanBlbEgrCtx with opaque names */
   void *(*ma)(void *, unsigned long);
   void (*mf)(void *);
@@ -43,23 +266,250 @@ struct ctxE { /* struct chanBlbEgrCtx with opaque names */
   chan_t *c;
   void *x;
   unsigned int (*xf)(void *, const unsigned char *, unsigned int);
+  unsigned int (*xv)(void *, const struct iovec *, int);
+  int r;
   void (*d)(void *);
-  /* opaque[2] */
+  /* opaque[3] */
   void (*xc)(void *);
-  volatile int *ex;
+  struct finCtx *fn;
+  struct egrBuf *ob;
+  unsigned int bk;                /* items per outputv() */
+  unsigned int co;                /* cork octets */
+  unsigned long cn;               /* cork nanoseconds */
+  chanBlbEgrS_t *st;
 };
 
+#define EGRHT 16 /* chanBlbEgrAdd head and tail maximum */
+
+struct egrBuf { /* items to coalesce */
+  struct iovec *v;    /* 3 per item */
+  void **m;           /* items */
+  unsigned char *h;   /* EGRHT per iovec, head and tail copies */
+  unsigned long l;    /* octets */
+  unsigned long t;    /* first add, CLOCK_MONOTONIC nanoseconds */
+  unsigned int n;     /* iovecs */
+  unsigned int k;     /* items */
+};
+
+static void
+egrRel(
+  void *v
+){
+#define V ((struct ctxE *)v)
+  while (V->ob->k)
+    if (V->r)
+      chanBlbRefFree(V->ob->m[--V->ob->k]);
+    else
+      V->mf(V->ob->m[--V->ob->k]);
+  V->ob->n = 0;
+  V->ob->l = 0;
+#undef V
+}
+
 static void
 finE(
   void *v
 ){
 #define V ((struct ctxE *)v)
-  *V->ex = 1;
+  struct finCtx *f;
+  int s;
+
+  pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &s);
+  f = V->fn;
+  pthread_mutex_lock(&f->m);
+  f->xE = 0;
+  pthread_cond_broadcast(&f->v);
+  pthread_mutex_unlock(&f->m);
   chanShut(V->c);
   chanClose(V->c);
+  if (V->ob) {
+    egrRel(v);
+    V->mf(V->ob);
+  }
   if (V->xc)
     V->xc(V->x);
   V->mf(v);
+  /* an ingress blocked in input() doesn't see its Channel shut, cancel it then */
+  if (f->cI) {
+    chanOp(0, f->cI, 0, chanOpSht);
+    pthread_mutex_lock(&f->m);
+    if (f->xI)
+      pthread_cancel(f->tI);
+    pthread_mutex_unlock(&f->m);
+  }
+  finRel(f);
+#undef V
+}
+
+unsigned char *
+chanBlbEgrOct(
+  struct chanBlbEgrCtx *v
+ ,void *m
+ ,unsigned int *l
+){
+  if (v->ref) {
+    *l = ((chanBlbRef_t *)m)->l;
+    return (((chanBlbRef_t *)m)->b);
+  }
+  *l = ((chanBlb_t *)m)->l;
+  return (((chanBlb_t *)m)->b);
+}
+
+int
+chanBlbEgrOutv(
+  struct chanBlbEgrCtx *v
+ ,struct iovec *d
+ ,int n
+){
+  unsigned int i;
+
+  for (;;) {
+    for (; n && !d->iov_len; ++d, --n);
+    if (!n)
+      return (1);
+    if (!(i = v->outv(v->outCtx, d, n)))
+      return (0);
+    for (; n && i >= d->iov_len; i -= d->iov_len, ++d, --n);
+    if (n) {
+      d->iov_base = (unsigned char *)d->iov_base + i;
+      d->iov_len -= i;
+    }
+  }
+}
+
+static unsigned long
+egrNs(
+  void
+){
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (t.tv_sec * 1000000000UL + t.tv_nsec);
+}
+
+/* output and release the coalesced items */
+static int
+egrFls(
+  void *v
+){
+#define V ((struct ctxE *)v)
+  int i;
+
+  if (!V->ob->n)
+    return (1);
+  i = chanBlbEgrOutv((struct chanBlbEgrCtx *)v, V->ob->v, V->ob->n);
+  if (V->st) {
+    __atomic_fetch_add(&V->st->flushes, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&V->st->items, V->ob->k, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&V->st->octets, V->ob->l, __ATOMIC_RELAXED);
+  }
+  egrRel(v);
+  return (i);
+#undef V
+}
+
+int
+chanBlbEgrGet(
+  struct chanBlbEgrCtx *v
+ ,void **m
+){
+#define V ((struct ctxE *)v)
+  chanArr_t p[1];
+
+  p[0].c = V->c;
+  p[0].v = m;
+  p[0].o = chanOpGet;
+  if (!V->ob)
+    return (chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet);
+  for (;;) {
+    long t;
+
+    if (!V->ob->n)
+      return (chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet);
+    if (V->ob->k < V->bk
+     && (!V->co || V->ob->l < V->co)) {
+      t = -1;
+      if (V->cn) {
+        unsigned long n;
+
+        if ((n = egrNs() - V->ob->t) < V->cn) {
+          t = V->cn - n;
+          if (V->st)
+            __atomic_fetch_add(&V->st->corks, 1, __ATOMIC_RELAXED);
+        }
+      }
+      if (chanOne(t, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet)
+        return (1);
+    }
+    if (!egrFls(v))
+      return (0);
+  }
+#undef V
+}
+
+int
+chanBlbEgrAdd(
+  struct chanBlbEgrCtx *v
+ ,const void *h
+ ,unsigned int hl
+ ,const void *o
+ ,unsigned int ol
+ ,const void *t
+ ,unsigned int tl
+ ,void *m
+){
+#define V ((struct ctxE *)v)
+  struct egrBuf *x;
+  unsigned char *d;
+
+  if (hl > EGRHT
+   || tl > EGRHT)
+    return (0);
+  if (!(x = V->ob)) {
+    struct iovec iv[3];
+
+    iv[0].iov_base = (void *)h;
+    iv[0].iov_len = hl;
+    iv[1].iov_base = (void *)o;
+    iv[1].iov_len = ol;
+    iv[2].iov_base = (void *)t;
+    iv[2].iov_len = tl;
+    if (!chanBlbEgrOutv(v, iv, 3))
+      return (0);
+    if (m) {
+      if (V->r)
+        chanBlbRefFree(m);
+      else
+        V->mf(m);
+    }
+    return (1);
+  }
+  if ((x->n + 3 > V->bk * 3
+    || x->k == V->bk)
+   && !egrFls(v))
+    return (0);
+  if (!x->n && V->cn)
+    x->t = egrNs();
+  if (hl) {
+    d = x->h + x->n * EGRHT;
+    memcpy(d, h, hl);
+    x->v[x->n].iov_base = d;
+    x->v[x->n++].iov_len = hl;
+  }
+  if (ol) {
+    x->v[x->n].iov_base = (void *)o;
+    x->v[x->n++].iov_len = ol;
+  }
+  if (tl) {
+    d = x->h + x->n * EGRHT;
+    memcpy(d, t, tl);
+    x->v[x->n].iov_base = d;
+    x->v[x->n++].iov_len = tl;
+  }
+  x->l += hl + ol + tl;
+  if (m)
+    x->m[x->k++] = m;
+  return (1);
 #undef V
 }
 
@@ -68,20 +518,27 @@ nfE(
   void *v
 ){
 #define V ((struct ctxE *)v)
-  chanBlb_t *m;
+  void *m;
   chanArr_t p[1];
 
   pthread_cleanup_push((void(*)(void*))V->d, v);
   p[0].c = V->c;
-  p[0].v = (void **)&m;
+  p[0].v = &m;
   p[0].o = chanOpGet;
-  while (chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+  while (V->ob ? chanBlbEgrGet(v, &m)
+               : chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+    unsigned char *b;
+    unsigned int n;
     unsigned int l;
     unsigned int i;
 
-    pthread_cleanup_push((void(*)(void*))V->mf, m);
-    for (l = 0, i = 1; l < m->l && (i = V->xf(V->x, m->b + l, m->l - l)) > 0; l += i);
-    pthread_cleanup_pop(1); /* V->mf(m) */
+    pthread_cleanup_push(V->r ? (void(*)(void*))chanBlbRefFree : (void(*)(void*))V->mf, m);
+    b = chanBlbEgrOct(v, m, &n);
+    if (V->ob)
+      l = i = chanBlbEgrAdd(v, 0, 0, b, n, 0, 0, m);
+    else
+      for (l = 0, i = 1; l < n && (i = V->xf(V->x, b + l, n - l)) > 0; l += i);
+    pthread_cleanup_pop(!V->ob || !i); /* free m, unless coalesced */
     if (!i)
       break;
   }
@@ -100,10 +557,25 @@ struct ctxI { /* struct chanBlbIgrCtx with opaque names */
   void *x;
   unsigned int (*xf)(void *, unsigned char *, unsigned int);
   chanBlb_t *b;
+  int r;
   void (*d)(void *);
-  /* opaque[2] */
+  /* opaque[3] */
   void (*xc)(void *);
-  volatile int *ex;
+  struct finCtx *fn;
+  struct igrBuf *rb;
+  unsigned char *ib;              /* default ingress buffer */
+  unsigned int (*xa)(void *);     /* input available */
+  chanBlbIgrS_t *st;
+  unsigned long e;                /* smoothed octets per input(), scaled by 8 */
+  int ad;                         /* adaptive size, else m */
+};
+
+#define IGRBUF 65536 /* chanBlbIgrInp buffer size */
+
+struct igrBuf {
+  unsigned int o;     /* offset */
+  unsigned int n;     /* octets */
+  unsigned char b[1]; /* the first of IGRBUF octets */
 };
 
 static void
@@ -111,13 +583,27 @@ finI(
   void *v
 ){
 #define V ((struct ctxI *)v)
-  *V->ex = 1;
+  struct finCtx *f;
+  int s;
+
+  pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &s);
+  f = V->fn;
+  pthread_mutex_lock(&f->m);
+  f->xI = 0;
+  pthread_cond_broadcast(&f->v);
+  pthread_mutex_unlock(&f->m);
   chanShut(V->c);
   chanClose(V->c);
   V->mf(V->b);
+  V->mf(V->rb);
+  V->mf(V->ib);
   if (V->xc)
     V->xc(V->x);
   V->mf(v);
+  /* an egress blocked in output() (e.g. the peer stopped reading) after its Channel is shut, cancel it after a grace */
+  if (f->cE)
+    finGrace(f, f->cE, &f->xE, &f->tE);
+  finRel(f);
 #undef V
 }
 
@@ -144,6 +630,126 @@ chanBlbIgrBlb(
   return (i);
 }
 
+unsigned int
+chanBlbIgrInp(
+  struct chanBlbIgrCtx *v
+ ,void *d
+ ,unsigned int l
+){
+  struct igrBuf *x;
+  unsigned int i;
+
+  if (v->blb)
+    return (chanBlbIgrBlb(v->free, &v->blb, d, l));
+  if (!(x = v->opaque[2])) {
+    if (l >= IGRBUF
+     || !(x = v->realloc(0, sizeof (*x) + IGRBUF - 1)))
+      return (v->inp(v->inpCtx, d, l));
+    x->o = x->n = 0;
+    v->opaque[2] = x;
+  }
+  if (!x->n) {
+    if (l >= IGRBUF)
+      return (v->inp(v->inpCtx, d, l));
+    if (!(i = v->inp(v->inpCtx, x->b, IGRBUF)))
+      return (0);
+    x->o = 0;
+    x->n = i;
+  }
+  i = l < x->n ? l : x->n;
+  memcpy(d, x->b + x->o, i);
+  x->o += i;
+  x->n -= i;
+  return (i);
+}
+
+static void
+disRef(
+  void *v
+){
+#define V ((chanBlbRef_t *)v)
+  ((struct blbRef *)V->opaque)->o = 0; /* blob remains the caller's */
+  chanBlbRefFree(V);
+#undef V
+}
+
+int
+chanBlbIgrPut(
+  struct chanBlbIgrCtx *v
+ ,chanBlb_t *b
+){
+  chanBlbRef_t *r;
+  int i;
+
+  if (!v->ref || !b)
+    return (chanOp(0, v->chan, (void **)&b, chanOpPut) == chanOsPut);
+  if (!(r = chanBlbRefBlb(v->realloc, v->free, b)))
+    return (0);
+  pthread_cleanup_push(disRef, r);
+  i = chanOp(0, v->chan, (void **)&r, chanOpPut) == chanOsPut;
+  pthread_cleanup_pop(!i); /* disRef(r) */
+  return (i);
+}
+
+#define IGRMIN 512 /* minimum default ingress size */
+
+/* size the next default ingress input() (at most m) after one offered o octets returned i (o is 0 at start)
+ *  if adaptive (a stream), twice the smoothed octets per input(), or, after a full input(), twice that or what is available
+ *  grow as needed, shrink when a quarter or less of size l
+ *  else m (a short datagram says nothing of the next, and a datagram larger than offered is cut off)
+ */
+static unsigned int
+igrSz(
+  void *v
+ ,unsigned int m
+ ,unsigned int l
+ ,unsigned int o
+ ,unsigned int i
+){
+#define V ((struct ctxI *)v)
+  unsigned long s;
+  unsigned int a;
+
+  if (o) {
+    V->e = V->e - (V->e >> 3) + i;
+    if (V->st) {
+      __atomic_fetch_add(&V->st->reads, 1, __ATOMIC_RELAXED);
+      __atomic_fetch_add(&V->st->octets, i, __ATOMIC_RELAXED);
+      __atomic_store_n(&V->st->smooth, V->e >> 3, __ATOMIC_RELAXED);
+    }
+  }
+  if (!V->ad)
+    s = m;
+  else {
+    s = (V->e >> 3) * 2;
+    if (o && i == o) {
+      if (s < (unsigned long)o * 2)
+        s = (unsigned long)o * 2;
+      if (V->xa && (a = V->xa(V->x)) > s)
+        s = a;
+    }
+    if (s < IGRMIN)
+      s = IGRMIN;
+  }
+  if (s > m)
+    s = m;
+  if (!l)
+    ;
+  else if (s > l) {
+    if (V->st)
+      __atomic_fetch_add(&V->st->grow, 1, __ATOMIC_RELAXED);
+  } else if (s * 4 <= l) {
+    if (V->st)
+      __atomic_fetch_add(&V->st->shrink, 1, __ATOMIC_RELAXED);
+  } else
+    s = l;
+  if (V->st)
+    __atomic_store_n(&V->st->size, s, __ATOMIC_RELAXED);
+  return (s);
+#undef V
+}
+
+/* input() reads into a buffer kept for the ingress, sized by igrSz(), and each item is allocated to size */
 static void *
 nfI(
   void *v
@@ -151,106 +757,111 @@ nfI(
 #define V ((struct ctxI *)v)
   chanBlb_t *m;
   chanArr_t p[1];
+  unsigned int x;
   unsigned int l;
+  unsigned int n;
   unsigned int i;
 
   pthread_cleanup_push((void(*)(void*))V->d, v);
-  l = V->g ? (long)V->g : 65536;
+  x = V->g ? (long)V->g : 65536;
+  l = igrSz(v, x, 0, 0, 0);
   p[0].c = V->c;
   p[0].v = (void **)&m;
   p[0].o = chanOpPut;
-  while ((m = V->ma(0, chanBlb_tSize(l)))) {
+  if (!(V->ib = V->ma(0, l)))
+    goto exit;
+  for (;;) {
     void *t;
 
-    pthread_cleanup_push((void(*)(void*))V->mf, m);
     if (V->b) {
-      if ((i = chanBlbIgrBlb(V->mf, &V->b, m->b, l)) < l)
-        i += V->xf(V->x, m->b + i, l - i);
+      if ((i = chanBlbIgrBlb(V->mf, &V->b, V->ib, l)) < l)
+        i += V->xf(V->x, V->ib + i, l - i);
     } else
-      i = V->xf(V->x, m->b, l);
-    pthread_cleanup_pop(0); /* V->mf(m) */
-    if (!i)
+      i = V->xf(V->x, V->ib, l);
+    if (!i
+     || !(m = V->ma(0, chanBlb_tSize(i))))
       break;
     m->l = i;
-    if ((t = V->ma(m, chanBlb_tSize(m->l))))
-      m = t;
+    memcpy(m->b, V->ib, i);
+    n = igrSz(v, x, l, l, i);
     pthread_cleanup_push((void(*)(void*))V->mf, m);
     i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
-    pthread_cleanup_pop(0); /* V->mf(m) */
+    pthread_cleanup_pop(!i); /* V->mf(m) */
     if (!i)
       break;
+    if (n != l) {
+      if (!(t = V->ma(V->ib, n)))
+        break;
+      V->ib = t;
+      l = n;
+    }
   }
-  V->mf(m);
+exit:
   pthread_cleanup_pop(1); /* V->d(v) */
   return (0);
 #undef V
 }
 
-/**********************************************************/
-
-struct monCtx {
-  void (*mf)(void *);
-  chan_t *cE;
-  chan_t *cI;
-  pthread_t tE;
-  pthread_t tI;
-  volatile int exE;
-  volatile int exI;
-  void *f;
-  void (*fc)(void *);
-};
-
-static void
-monFin(
-  void *v
-#define V ((struct monCtx *)v)
-){
-  if (V->cE) {
-    if (!V->exE)
-      pthread_cancel(V->tE);
-    pthread_join(V->tE, 0);
-    chanClose(V->cE);
-  }
-  if (V->cI) {
-    if (!V->exI)
-      pthread_cancel(V->tI);
-    pthread_join(V->tI, 0);
-    chanClose(V->cI);
-  }
-  if (V->fc)
-    V->fc(V->f);
-  V->mf(v);
-#undef V
-}
-
+/* without a framer, chanBlbRef_t items are slices of a shared input buffer */
+/* every input() is offered at least l octets (sized by igrSz()), so a buffer backs two or more reads */
 static void *
-monT(
+nfIr(
   void *v
-#define V ((struct monCtx *)v)
 ){
-  chanArr_t p[2];
+#define V ((struct ctxI *)v)
+  chanBlbRef_t *r;
+  chanBlbRef_t *m;
+  chanArr_t p[1];
+  unsigned int x;
+  unsigned int l;
   unsigned int n;
+  unsigned int o;
   unsigned int i;
-  struct timespec ts;
 
-  pthread_cleanup_push(monFin, v);
-  p[0].c = V->cE; p[0].v = 0; p[0].o = chanOpSht;
-  p[1].c = V->cI; p[1].v = 0; p[1].o = chanOpSht;
-  while (p[0].c || p[1].c) {
-    if (!(n = chanOne(0, 2, p)))
-      break;
-    --n;
-    if (p[n].s == chanOsSht)
-      p[n].c = 0;
+  pthread_cleanup_push((void(*)(void*))V->d, v);
+  x = V->g ? (long)V->g : 65536;
+  l = igrSz(v, x, 0, 0, 0);
+  p[0].c = V->c;
+  p[0].v = (void **)&m;
+  p[0].o = chanOpPut;
+  r = 0;
+  o = 0;
+  if (V->b) {
+    if (!(m = chanBlbRefBlb(V->ma, V->mf, V->b)))
+      goto exit;
+    V->b = 0;
+    pthread_cleanup_push((void(*)(void*))chanBlbRefFree, m);
+    i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
+    pthread_cleanup_pop(!i); /* chanBlbRefFree(m) */
+    if (!i)
+      goto exit;
   }
-  ts.tv_sec = 1;
-  ts.tv_nsec = 0;
-  for (i = 0; i < 1800; ++i) {
-    if ((!V->cE || V->exE) && (!V->cI || V->exI))
+  for (;;) {
+    if (!r || r->l - o < l) {
+      chanBlbRefFree(r);
+      if (!(r = chanBlbRefNew(V->ma, V->mf, 0, l > ~0U / 2 ? l : l * 2, 0)))
+        break;
+      o = 0;
+    }
+    n = r->l - o;
+    pthread_cleanup_push((void(*)(void*))chanBlbRefFree, r);
+    i = V->xf(V->x, r->b + o, n);
+    pthread_cleanup_pop(0); /* chanBlbRefFree(r) */
+    if (!i || !(m = chanBlbRefSlc(r, o, i)))
+      break;
+    l = igrSz(v, x, l, n, i);
+    o += i;
+    pthread_cleanup_push((void(*)(void*))chanBlbRefFree, r);
+    pthread_cleanup_push((void(*)(void*))chanBlbRefFree, m);
+    i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
+    pthread_cleanup_pop(!i); /* chanBlbRefFree(m) */
+    pthread_cleanup_pop(0); /* chanBlbRefFree(r) */
+    if (!i)
       break;
-    nanosleep(&ts, 0);
   }
-  pthread_cleanup_pop(1);
+exit:
+  chanBlbRefFree(r);
+  pthread_cleanup_pop(1); /* V->d(v) */
   return (0);
 #undef V
 }
@@ -258,7 +869,7 @@ monT(
 /**********************************************************/
 
 int
-chanBlb(
+chanBlbOpt(
   void *(*ma)(void *, unsigned long)
  ,void (*mf)(void *)
 
@@ -280,18 +891,26 @@ chanBlb(
  ,void *f
  ,void (*fc)(void *)
 
+ ,const chanBlbOpt_t *o
  ,pthread_attr_t *a
 ){
+  static const chanBlbOpt_t z; /* none */
+  unsigned int (*otv)(void *, const struct iovec *, int);
+  unsigned int (*ina)(void *);
+  unsigned int ek;
   pthread_t tE;
   pthread_t tI;
-  struct monCtx *m;
-  pthread_t t;
+  pthread_t tW;
+  struct finCtx *m;
   int hE;
-  int hI;
   int hM;
 
+  if (!o)
+    o = &z;
+  otv = o->outputv;
+  ina = o->inputAvail;
+  ek = o->egressItems;
   hE = 0;
-  hI = 0;
   hM = 0;
   if (!ma || !mf
    || (!e && !i)
@@ -302,14 +921,24 @@ chanBlb(
   mf(ma(0, 1)); /* force exception here and now */
   if (!(m = ma(0, sizeof (*m))))
     goto error;
+  if (pthread_mutex_init(&m->m, 0)) {
+    mf(m);
+    goto error;
+  }
+  if (pthread_cond_init(&m->v, 0)) {
+    pthread_mutex_destroy(&m->m);
+    mf(m);
+    goto error;
+  }
   hM = 1;
   m->mf = mf;
-  m->cE = 0;
-  m->cI = 0;
-  m->exE = 0;
-  m->exI = 0;
   m->f = f;
   m->fc = fc;
+  m->cE = chanOpen(e);
+  m->cI = chanOpen(i);
+  m->n = 1;
+  m->xE = e ? 1 : 0;
+  m->xI = i ? 1 : 0;
 
   if (e) {
     struct ctxE *x;
@@ -321,17 +950,46 @@ chanBlb(
     x->c = chanOpen(e);
     x->x = ot;
     x->xf = otf;
+    x->xv = otv;
     x->xc = otc;
     x->d = finE;
     x->g = eg;
-    x->ex = &m->exE;
+    x->r = o->egressRef;
+    x->fn = m;
+    x->ob = 0;
+    x->bk = ek;
+    x->co = o->egressCorkOctets;
+    x->cn = o->egressCorkNs;
+    x->st = o->egressStats;
+    if (otv && ek > 1) {
+      long l;
+
+      if ((l = sysconf(_SC_IOV_MAX)) < 16)
+        l = 16;
+      if (ek > l / 3)
+        x->bk = ek = l / 3;
+      if (!(x->ob = ma(0, sizeof (*x->ob) + ek * (3 * sizeof (*x->ob->v) + sizeof (*x->ob->m) + 3 * EGRHT)))) {
+        chanClose(x->c);
+        mf(x);
+        goto error;
+      }
+      x->ob->v = (struct iovec *)(x->ob + 1);
+      x->ob->m = (void **)(x->ob->v + 3 * ek);
+      x->ob->h = (unsigned char *)(x->ob->m + ek);
+      x->ob->l = 0;
+      x->ob->n = 0;
+      x->ob->k = 0;
+    }
+    m->n = 2;
     if (pthread_create(&tE, a, fe ? (void *(*)(void *))fe : nfE, x)) {
+      m->n = 1;
       chanClose(x->c);
+      mf(x->ob);
       mf(x);
       goto error;
     }
-    hE = 1;
     m->tE = tE;
+    hE = 1;
     otc = 0;
   } else if (otc)
     otc(ot);
@@ -349,46 +1007,102 @@ chanBlb(
     x->d = finI;
     x->g = ig;
     x->b = b;
-    x->ex = &m->exI;
-    if (pthread_create(&tI, a, fi ? (void *(*)(void *))fi : nfI, x)) {
+    x->r = o->ingressRef;
+    x->fn = m;
+    x->rb = 0;
+    x->ib = 0;
+    x->xa = ina;
+    x->ad = o->ingressAdaptive;
+    x->st = o->ingressStats;
+    x->e = 2048 << 3;
+    pthread_mutex_lock(&m->m); /* egress may read the ingress thread */
+    ++m->n;
+    if (pthread_create(&tI, a, fi ? (void *(*)(void *))fi : o->ingressRef ? nfIr : nfI, x)) {
+      --m->n;
+      m->xI = 0;
+      pthread_mutex_unlock(&m->m);
       chanClose(x->c);
       mf(x);
       goto error;
     }
-    hI = 1;
     m->tI = tI;
+    pthread_mutex_unlock(&m->m);
+    pthread_detach(tI);
     b = 0;
     inc = 0;
   } else if (inc)
     inc(in);
-  m->cE = chanOpen(e);
-  m->cI = chanOpen(i);
-  if (pthread_create(&t, a, monT, m)) {
-    chanClose(m->cE);
-    chanClose(m->cI);
-    goto error;
+  if (hE)
+    pthread_detach(tE);
+  /* a lone direction, blocked after its Channel is shut, is cancelled after a grace by a watch */
+  if (!e != !i) {
+    pthread_mutex_lock(&m->m);
+    ++m->n;
+    pthread_mutex_unlock(&m->m);
+    if (pthread_create(&tW, a, finW, m)) {
+      pthread_mutex_lock(&m->m);
+      --m->n;
+      if (m->xE)
+        pthread_cancel(m->tE);
+      if (m->xI)
+        pthread_cancel(m->tI);
+      pthread_mutex_unlock(&m->m);
+      chanShut(e);
+      chanShut(i);
+      finRel(m); /* fc(f) by the direction */
+      return (0);
+    }
+    pthread_detach(tW);
   }
-  pthread_detach(t);
+  finRel(m);
   return (1);
 error:
   if (hE) {
+    pthread_mutex_lock(&m->m);
+    m->xI = 0;
+    pthread_mutex_unlock(&m->m);
     chanShut(e);
-    pthread_join(tE, 0);
-  }
-  if (hI) {
     chanShut(i);
-    pthread_join(tI, 0);
+    pthread_join(tE, 0);
   }
-  if (hM)
-    mf(m);
   chanShut(e);
   chanShut(i);
   if (otc)
     otc(ot);
   if (inc)
     inc(in);
-  if (fc)
-    fc(f);
   mf(b);
+  if (hM)
+    finRel(m); /* fc(f) */
+  else if (fc)
+    fc(f);
   return (0);
 }
+
+int
+chanBlb(
+  void *(*ma)(void *, unsigned long)
+ ,void (*mf)(void *)
+
+ ,chan_t *e
+ ,void *ot
+ ,unsigned int (*otf)(void *, const unsigned char *, unsigned int)
+ ,void (*otc)(void *)
+ ,void *eg
+ ,void *(*fe)(struct chanBlbEgrCtx *)
+
+ ,chan_t *i
+ ,void *in
+ ,unsigned int (*inf)(void *, unsigned char *, unsigned int)
+ ,void (*inc)(void *)
+ ,void *ig
+ ,void *(*fi)(struct chanBlbIgrCtx *)
+ ,chanBlb_t *b
+
+ ,void *f
+ ,void (*fc)(void *)
+
+ ,pthread_attr_t *a
+){
+  return (chanBlbOpt(ma, mf, e, ot, otf, otc, eg, fe, i, in, inf, inc, ig, fi, b, f, fc, 0, a));
+}
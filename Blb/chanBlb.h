@@ -21,6 +21,8 @@
 #ifndef __CHANBLB_H__
 #define __CHANBLB_H__
 
+struct iovec;
+
 /* a blob (a length prefixed array of bytes) */
 typedef struct {
   unsigned int l;     /* not transmitted, no byte order issues */
@@ -33,8 +35,75 @@ chanBlb_tSize(
   unsigned int octets
 );
 
+/* a reference counted blob (a slice of l octets at b in a shared buffer)
+ *
+ * Each chanBlbRef_t is one reference to the shared buffer, the buffer is released with the last reference.
+ * Slices are cheap (no octets are copied), so one buffer can back many items and fan-out needs no deep copy.
+ * A buffer can be allocated with headroom and tailroom so framing octets can be added in place.
+ *
+ * The shared buffer is only written by the holder of its only reference.
+ */
+typedef struct {
+  unsigned int l;     /* not transmitted, no byte order issues */
+  unsigned char *b;   /* the first character of l characters */
+  void *opaque;       /* shared buffer */
+} chanBlbRef_t;
+
+/* return a reference to a new buffer of head + octets + tail, sliced to octets after head (0 on failure) */
+chanBlbRef_t *
+chanBlbRefNew(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,unsigned int head
+ ,unsigned int octets
+ ,unsigned int tail
+);
+
+/* return a reference to a buffer that takes ownership of a chanBlb_t without copying (0 on failure, blob unchanged) */
+chanBlbRef_t *
+chanBlbRefBlb(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,chanBlb_t *blob
+);
+
+/* return an additional reference, a slice of octets at offset within a reference (0 on failure) */
+chanBlbRef_t *
+chanBlbRefSlc(
+  chanBlbRef_t *ref
+ ,unsigned int offset
+ ,unsigned int octets
+);
+
+/* grow a slice into head and tail room when it holds the only reference to its buffer
+ *  return the new first octet, else 0 (slice unchanged)
+ */
+unsigned char *
+chanBlbRefGrow(
+  chanBlbRef_t *ref
+ ,unsigned int head
+ ,unsigned int tail
+);
+
+/* release a reference, on last reference release the buffer */
+/* calling with 0 is a harmless no-op */
+void
+chanBlbRefFree(
+  chanBlbRef_t *ref
+);
+
 /**********************************************************/
 
+/* observations of a coalescing egress, each updated atomically (read them with __atomic_load_n)
+ *  items / flushes is the average items per outputv()
+ */
+typedef struct {
+  unsigned long flushes; /* outputs of coalesced items */
+  unsigned long items;   /* items output */
+  unsigned long octets;  /* octets output, with framing */
+  unsigned long corks;   /* waits for more items */
+} chanBlbEgrS_t;
+
 struct chanBlbEgrCtx {
   void *(*realloc)(void *, unsigned long);
   void (*free)(void *);
@@ -42,8 +111,10 @@ struct chanBlbEgrCtx {
   chan_t *chan;
   void *outCtx;
   unsigned int (*out)(void *outCtx, const void *buffer, unsigned int length);
+  unsigned int (*outv)(void *outCtx, const struct iovec *iov, int iovcnt); /* optional, 0 if not provided */
+  int ref; /* chan items are chanBlbRef_t, else chanBlb_t */
   void (*fin)(void *chanBlbEgrCtx);
-  void *opaque[2];
+  void *opaque[3];
 };
 
 struct chanBlbIgrCtx {
@@ -54,10 +125,78 @@ struct chanBlbIgrCtx {
   void *inpCtx;
   unsigned int (*inp)(void *inpCtx, void *buffer, unsigned int length);
   chanBlb_t *blb;
+  int ref; /* chan items are chanBlbRef_t, else chanBlb_t */
   void (*fin)(void *chanBlbIgrCtx);
-  void *opaque[2];
+  void *opaque[3];
 };
 
+/* observations and decisions of a default (no framer) ingress, each updated atomically (read them with __atomic_load_n)
+ *  input() is offered a size steered by the smoothed (1/8 EWMA) octets per input(), doubled,
+ *  or, when an input() fills it, by what inputAvail() reports is waiting, within the ingress framer context maximum
+ */
+typedef struct {
+  unsigned long reads;  /* input() calls */
+  unsigned long octets; /* octets input */
+  unsigned long smooth; /* smoothed octets per input() */
+  unsigned long size;   /* current size */
+  unsigned long grow;   /* size increases */
+  unsigned long shrink; /* size decreases */
+} chanBlbIgrS_t;
+
+/* utility to locate the octets of a chanBlbEgrCtx->chan item, return first octet and set length */
+unsigned char *
+chanBlbEgrOct(
+  struct chanBlbEgrCtx *v
+ ,void *item
+ ,unsigned int *length
+);
+
+/* utility to output all of an iovec array with chanBlbEgrCtx->outv (the array is updated on partial output)
+ *  return non-zero on success
+ */
+int
+chanBlbEgrOutv(
+  struct chanBlbEgrCtx *v
+ ,struct iovec *iov
+ ,int iovcnt
+);
+
+/* utilities for egress framers to coalesce items into fewer outv() calls (outv required)
+ *
+ * chanBlbEgrGet Gets the next item, return 0 when the chan is shut (or on failure)
+ *  it only blocks when nothing is pending, else outputs what is pending when no item is ready
+ *  (or after the cork wait, or when the batch is full)
+ * chanBlbEgrAdd adds an item's head, octets and tail (head and tail at most 16 octets, copied)
+ *  the item, if not 0, is released once output, return 0 on failure (the item remains the caller's)
+ *  without coalescing, outputs immediately
+ */
+int
+chanBlbEgrGet(
+  struct chanBlbEgrCtx *v
+ ,void **item
+);
+
+int
+chanBlbEgrAdd(
+  struct chanBlbEgrCtx *v
+ ,const void *head
+ ,unsigned int headLength
+ ,const void *octets
+ ,unsigned int length
+ ,const void *tail
+ ,unsigned int tailLength
+ ,void *item
+);
+
+/* utility to Put a chanBlb_t on chanBlbIgrCtx->chan (as a chanBlbRef_t, without copying, when chanBlbIgrCtx->ref)
+ *  return non-zero on success, else the blob remains the caller's
+ */
+int
+chanBlbIgrPut(
+  struct chanBlbIgrCtx *v
+ ,chanBlb_t *blob
+);
+
 /* utility to injest chanBlbIgrCtx->blb */
 unsigned int
 chanBlbIgrBlb(
@@ -67,6 +206,19 @@ chanBlbIgrBlb(
  ,unsigned int len
 );
 
+/* utility for stream framers to input up to len octets (return 0 on failure)
+ *  from chanBlbIgrCtx->blb, then from a buffer the bridge keeps for the ingress
+ *  the buffer is filled by one large inp(), so small (header) reads don't each cost a syscall
+ *  reads at least the size of the buffer bypass it when it is empty
+ *  (datagram boundaries are not kept)
+ */
+unsigned int
+chanBlbIgrInp(
+  struct chanBlbIgrCtx *v
+ ,void *destination
+ ,unsigned int len
+);
+
 /* Channel Blob
  *
  * Support input/output via ingress and egress channels.
@@ -81,6 +233,7 @@ chanBlbIgrBlb(
  * Provide an optional ingress chan_t: (if not provided, inputClose(inputCtx) is called immediately)
  *  Otherwise, input() is required, inputClose() is optional.
  * Provide an optional ingress framer context
+ *  without an ingress framer, the maximum octets per item (0 for 65536)
  * Provide an optional ingress framer
  * Provide an optional initial blob; previous input bytes from protocol start
  *
@@ -90,7 +243,10 @@ chanBlbIgrBlb(
  *  A chanOpGet or output() failure will chanShut(egress) and outputClose(outputCtx).
  * A chanOpGet on the ingress channel will return chanBlb_t items from input():
  *  A chanOpPut or input() failure will chanShut(ingress) and inputClose(inputCtx).
- * After all chanShut(), if provided, finlClose(finlCtx) is invoked
+ * After all chanShut(), if provided, finlClose(finlCtx) is invoked (by the last direction out)
+ *  An ingress blocked in input() when its channel is chanShut() is cancelled by the egress (if any)
+ *  An egress blocked in output() 1800 seconds after its channel is chanShut() is cancelled by the ingress (if any)
+ *  A lone direction (no ingress or no egress) blocked 1800 seconds after its channel is chanShut() is cancelled
  *
  * Provide an optional pthread_create attribute
  *
@@ -129,4 +285,57 @@ chanBlb(
  ,pthread_attr_t *attr
 );
 
+/* chanBlbOpt() options, zero (or a 0 options) for none, as chanBlb() */
+typedef struct {
+  /* an iovec array output (like writev), so egress framers add framing octets without copying */
+  unsigned int (*outputv)(void *outputCtx, const struct iovec *iov, int iovcnt); /* return 0 on failure */
+  /* the octets input() can return without blocking (0 if unknown), used when ingressAdaptive */
+  unsigned int (*inputAvail)(void *inputCtx);
+  /* egress items are chanBlbRef_t, else chanBlb_t */
+  int egressRef;
+  /* ingress items are chanBlbRef_t, else chanBlb_t (without an ingress framer, slices of a shared input buffer) */
+  int ingressRef;
+  /* with outputv() of a stream, the most items per outputv(), else 0
+   *  it must be 0 for a transport that keeps message boundaries (a datagram), where an outputv() is one message */
+  unsigned int egressItems;
+  /* with it, till cork octets are pending, wait up to cork nanoseconds after the first */
+  unsigned int egressCorkOctets;
+  unsigned long egressCorkNs;
+  /* updated when coalescing */
+  chanBlbEgrS_t *egressStats;
+  /* without an ingress framer, size input() to what arrives, else offer the maximum
+   *  only for a stream, a transport that keeps message boundaries (a datagram) must be offered the maximum */
+  int ingressAdaptive;
+  /* updated without an ingress framer */
+  chanBlbIgrS_t *ingressStats;
+} chanBlbOpt_t;
+
+/* chanBlb() with options */
+int
+chanBlbOpt(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+
+ ,chan_t *egress
+ ,void *outputCtx
+ ,unsigned int (*output)(void *outputCtx, const unsigned char *buffer, unsigned int size) /* return 0 on failure */
+ ,void (*outputClose)(void *outputCtx)
+ ,void *egressFrmCtx
+ ,void *(*egressFrm)(struct chanBlbEgrCtx *)
+
+ ,chan_t *ingress
+ ,void *inputCtx
+ ,unsigned int (*input)(void *inputCtx, unsigned char *buffer, unsigned int size) /* return 0 on failure */
+ ,void (*inputClose)(void *inputCtx)
+ ,void *ingressFrmCtx
+ ,void *(*ingressFrm)(struct chanBlbIgrCtx *)
+ ,chanBlb_t *blb
+
+ ,void *finalCtx
+ ,void (*finalClose)(void *finalCtx)
+
+ ,const chanBlbOpt_t *options
+ ,pthread_attr_t *attr
+);
+
 #endif /* __CHANBLB_H__ */
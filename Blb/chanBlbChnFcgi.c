@@ -28,51 +28,67 @@ chanBlbChnFcgiEgr(
   struct chanBlbEgrCtx *v
 ){
   unsigned char *b;
-  chanBlb_t *m;
+  void *m;
   chanArr_t p[1];
 
   pthread_cleanup_push((void(*)(void*))v->fin, v);
-  if (!(b = v->realloc(0, 8 + 65535 + 255)))
+  if (!(b = v->realloc(0, v->outv ? 8 + 7 : 8 + 65535 + 255))) /* with outv, header and zero padding */
     goto bad;
   *b = 1; /* FCGI_VERSION_1 */
   pthread_cleanup_push((void(*)(void*))v->free, b);
   p[0].c = v->chan;
-  p[0].v = (void **)&m;
+  p[0].v = &m;
   p[0].o = chanOpGet;
-  while (chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+  while (v->outv ? chanBlbEgrGet(v, &m)
+                 : chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+    unsigned char *s;
+    unsigned int n;
     unsigned int i;
+    int k;
 
-    pthread_cleanup_push((void(*)(void*))v->free, m);
-    if (m->l > 2) { /* type, request1, request0 */
+    pthread_cleanup_push(v->ref ? (void(*)(void*))chanBlbRefFree : (void(*)(void*))v->free, m);
+    s = chanBlbEgrOct(v, m, &n);
+    k = 0;
+    if (n > 2) { /* type, request1, request0 */
       unsigned int o1;
       unsigned int l1;
 
-      *(b + 1) = *(m->b + 0);
-      *(b + 2) = *(m->b + 1);
-      *(b + 3) = *(m->b + 2);
-      if (m->l == 3) {
+      *(b + 1) = *(s + 0);
+      *(b + 2) = *(s + 1);
+      *(b + 3) = *(s + 2);
+      if (n == 3) {
         *(b + 4) = *(b + 5) = *(b + 6) = 0;
-        for (o1 = 0, l1 = 8; o1 < l1 && (i = v->out(v->outCtx, b + o1, l1 - o1)) > 0; o1 += i);
-      } else for (o1 = 3; o1 < m->l; o1 += l1) {
+        if (v->outv)
+          k = i = chanBlbEgrAdd(v, b, 8, 0, 0, 0, 0, m);
+        else for (o1 = 0, l1 = 8; o1 < l1 && (i = v->out(v->outCtx, b + o1, l1 - o1)) > 0; o1 += i);
+      } else for (o1 = 3; o1 < n; o1 += l1) {
         unsigned char *s1;
         unsigned char *s2;
         unsigned int o2;
         unsigned int l2;
 
-        if ((l1 = m->l - o1) > 65535)
+        if ((l1 = n - o1) > 65535)
           l1 = 65535;
         *(b + 4) = l1 >> 8 & 0xff;
         *(b + 5) = l1 >> 0 & 0xff;
         i = l1 % 8;
         *(b + 6) = i;
-        for (s2 = b + 8, s1 = m->b + o1, l2 = l1; l2; ++s2, ++s1, --l2)
+        if (v->outv) { /* header, content and padding gathered, the last releases m */
+          for (s2 = b + 8, l2 = i; l2; ++s2, --l2)
+            *s2 = 0;
+          if (!(k = i = chanBlbEgrAdd(v, b, 8, s + o1, l1, b + 8, i, o1 + l1 < n ? 0 : m)))
+            break;
+          k = o1 + l1 >= n;
+          continue;
+        }
+        for (s2 = b + 8, s1 = s + o1, l2 = l1; l2; ++s2, ++s1, --l2)
           *s2 = *s1;
         l2 = 8 + l1 + i;
         for (o2 = 0; o2 < l2 && (i = v->out(v->outCtx, b + o2, l2 - o2)) > 0; o2 += i);
       }
     } else
       i = 0;
-    pthread_cleanup_pop(1); /* v->free(m) */
+    pthread_cleanup_pop(!k); /* free m, unless added */
     if (!i)
       break;
   }
@@ -88,7 +104,6 @@ chanBlbChnFcgiIgr(
 ){
   unsigned char *b;
   chanBlb_t *m;
-  chanArr_t p[1];
   unsigned int l;
   unsigned int i0;
   unsigned int i;
@@ -98,9 +113,6 @@ chanBlbChnFcgiIgr(
   if (!(b = v->realloc(0, l)))
     goto bad;
   pthread_cleanup_push((void(*)(void*))v->free, b);
-  p[0].c = v->chan;
-  p[0].v = (void **)&m;
-  p[0].o = chanOpPut;
   i0 = 0;
   while ((i = v->blb ? chanBlbIgrBlb(v->free, &v->blb, b + i0, l - i0)
                      : v->inp(v->inpCtx, b + i0, l - i0)) > 0) {
@@ -126,7 +138,7 @@ next:
     *(m->b + 2) = *(b + 3);
     for (s2 = m->b + 3, s1 = b + 8; i1; ++s2, ++s1, --i1)
       *s2 = *s1;
-    i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
+    i = chanBlbIgrPut(v, m);
     pthread_cleanup_pop(0); /* v->free(m) */
     if (!i) {
       v->free(m);
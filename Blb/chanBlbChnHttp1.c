@@ -28,7 +28,6 @@ chanBlbChnHttp1Igr(
   struct chanBlbIgrCtx *v
 ){
   chanBlb_t *m;
-  chanArr_t p[1];
   unsigned int l;
   unsigned int i0;
   unsigned int i1;
@@ -36,9 +35,6 @@ chanBlbChnHttp1Igr(
 
   l = v->frmCtx ? (long)v->frmCtx : 65536; /* when zero maxSize, balance data rate, io() call overhead and realloc() release policy */
   pthread_cleanup_push((void(*)(void*))v->fin, v);
-  p[0].c = v->chan;
-  p[0].v = (void **)&m;
-  p[0].o = chanOpPut;
   i1 = 0;
   if (v->blb) {
     m = v->blb;
@@ -220,7 +216,7 @@ endHeaders:
       m = tv;
     pthread_cleanup_push((void(*)(void*))v->free, m);
     pthread_cleanup_push((void(*)(void*))v->free, m1);
-    i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
+    i = chanBlbIgrPut(v, m);
     pthread_cleanup_pop(0); /* v->free(m1) */
     pthread_cleanup_pop(0); /* v->free(m) */
     if (!i) {
@@ -298,7 +294,7 @@ sizeHeader:
         i2 -= ch;
         pthread_cleanup_push((void(*)(void*))v->free, m);
         pthread_cleanup_push((void(*)(void*))v->free, m1);
-        i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
+        i = chanBlbIgrPut(v, m);
         pthread_cleanup_pop(0); /* v->free(m1) */
         pthread_cleanup_pop(0); /* v->free(m) */
         if (!i) {
@@ -374,7 +370,7 @@ endTrailers:
       cl = 0;
       pthread_cleanup_push((void(*)(void*))v->free, m);
       pthread_cleanup_push((void(*)(void*))v->free, m1);
-      i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
+      i = chanBlbIgrPut(v, m);
       pthread_cleanup_pop(0); /* v->free(m1) */
       pthread_cleanup_pop(0); /* v->free(m) */
       if (!i) {
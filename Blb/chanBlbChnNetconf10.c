@@ -27,21 +27,42 @@ void *
 chanBlbChnNetconf10Egr(
   struct chanBlbEgrCtx *v
 ){
-  chanBlb_t *m;
+  void *m;
   chanArr_t p[1];
 
   pthread_cleanup_push((void(*)(void*))v->fin, v);
   p[0].c = v->chan;
-  p[0].v = (void **)&m;
+  p[0].v = &m;
   p[0].o = chanOpGet;
-  while (chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+  while (v->outv ? chanBlbEgrGet(v, &m)
+                 : chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+    unsigned char *s;
     unsigned char *t;
+    unsigned int n;
     unsigned int o;
     unsigned int l;
     unsigned int i;
+    int k;
 
-    pthread_cleanup_push((void(*)(void*))v->free, m);
-    l = m->l + 6;
+    pthread_cleanup_push(v->ref ? (void(*)(void*))chanBlbRefFree : (void(*)(void*))v->free, m);
+    s = chanBlbEgrOct(v, m, &n);
+    k = 0;
+    if (v->outv) { /* octets and trailer gathered */
+      k = i = chanBlbEgrAdd(v, 0, 0, s, n, "]]>]]>", 6, m);
+      goto next;
+    }
+    if (v->ref && (t = chanBlbRefGrow(m, 0, 6))) { /* trailer in place */
+      s = t + n;
+      *s++ = ']';
+      *s++ = ']';
+      *s++ = '>';
+      *s++ = ']';
+      *s++ = ']';
+      *s = '>';
+      for (l = n + 6, o = 0; o < l && (i = v->out(v->outCtx, t + o, l - o)) > 0; o += i);
+      goto next;
+    }
+    l = n + 6;
     if (!(t = v->realloc(0, l)))
       l = 0;
     if (l) {
@@ -49,7 +70,7 @@ chanBlbChnNetconf10Egr(
       unsigned char *s2;
 
       pthread_cleanup_push((void(*)(void*))v->free, t);
-      for (s2 = t, s1 = m->b, o = m->l; o; --o, ++s2, ++s1)
+      for (s2 = t, s1 = s, o = n; o; --o, ++s2, ++s1)
         *s2 = *s1;
       *s2++ = ']';
       *s2++ = ']';
@@ -61,7 +82,8 @@ chanBlbChnNetconf10Egr(
       pthread_cleanup_pop(1); /* v->free(t) */
     } else
       i = 0;
-    pthread_cleanup_pop(1); /* v->free(m) */
+next:
+    pthread_cleanup_pop(!k); /* free m, unless added */
     if (!i)
       break;
   }
@@ -74,7 +96,6 @@ chanBlbChnNetconf10Igr(
   struct chanBlbIgrCtx *v
 ){
   chanBlb_t *m;
-  chanArr_t p[1];
   unsigned int l;
   unsigned int i0;
   unsigned int i1;
@@ -82,9 +103,6 @@ chanBlbChnNetconf10Igr(
 
   l = v->frmCtx ? (long)v->frmCtx : 65536; /* when zero maxSize, balance data rate, io() call overhead and realloc() release policy */
   pthread_cleanup_push((void(*)(void*))v->fin, v);
-  p[0].c = v->chan;
-  p[0].v = (void **)&m;
-  p[0].o = chanOpPut;
   i1 = 0;
   if (v->blb) {
     m = v->blb;
@@ -139,7 +157,7 @@ found:
       m = tv;
     pthread_cleanup_push((void(*)(void*))v->free, m);
     pthread_cleanup_push((void(*)(void*))v->free, m1);
-    i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
+    i = chanBlbIgrPut(v, m);
     pthread_cleanup_pop(0); /* v->free(m1) */
     pthread_cleanup_pop(0); /* v->free(m) */
     if (!i) {
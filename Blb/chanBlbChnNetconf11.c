@@ -27,27 +27,57 @@ void *
 chanBlbChnNetconf11Egr(
   struct chanBlbEgrCtx *v
 ){
-  chanBlb_t *m;
+  void *m;
   chanArr_t p[1];
 
   pthread_cleanup_push((void(*)(void*))v->fin, v);
   p[0].c = v->chan;
-  p[0].v = (void **)&m;
+  p[0].v = &m;
   p[0].o = chanOpGet;
-  while (chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+  while (v->outv ? chanBlbEgrGet(v, &m)
+                 : chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+    unsigned char *s;
     unsigned char *t;
+    unsigned int n;
     unsigned int o;
     unsigned int l;
     unsigned int i;
-    unsigned char b[16];
+    int k;
+    unsigned char b[17];
 
-    pthread_cleanup_push((void(*)(void*))v->free, m);
-    for (l = m->l, o = sizeof (b); l && o; l /= 10)
+    pthread_cleanup_push(v->ref ? (void(*)(void*))chanBlbRefFree : (void(*)(void*))v->free, m);
+    s = chanBlbEgrOct(v, m, &n);
+    b[16] = '\n';
+    for (l = n, o = 16; l && o; l /= 10)
       b[--o] = l % 10 + '0';
+    k = 0;
     if (!l) {
-      i = sizeof (b) - o;
-      if (m->l)
-        l = 2 + i + 1 + m->l + 4;
+      i = 16 - o;
+      if (v->outv) { /* header, octets and trailer gathered */
+        b[--o] = '#';
+        b[--o] = '\n';
+        k = i = chanBlbEgrAdd(v, &b[o], n ? 2 + i + 1 : 0, s, n, "\n##\n", 4, m);
+        goto next;
+      }
+      if (v->ref && (t = chanBlbRefGrow(m, n ? 2 + i + 1 : 0, 4))) { /* header and trailer in place */
+        s = t;
+        if (n) {
+          *s++ = '\n';
+          *s++ = '#';
+          for (; i; --i, ++s, ++o)
+            *s = b[o];
+          *s++ = '\n';
+          s += n;
+        }
+        *s++ = '\n';
+        *s++ = '#';
+        *s++ = '#';
+        *s = '\n';
+        for (l = ((chanBlbRef_t *)m)->l, o = 0; o < l && (i = v->out(v->outCtx, t + o, l - o)) > 0; o += i);
+        goto next;
+      }
+      if (n)
+        l = 2 + i + 1 + n + 4;
       else
         l = 4;
       if (!(t = v->realloc(0, l)))
@@ -59,13 +89,13 @@ chanBlbChnNetconf11Egr(
 
       pthread_cleanup_push((void(*)(void*))v->free, t);
       s2 = t;
-      if (m->l) {
+      if (n) {
         *s2++ = '\n';
         *s2++ = '#';
         for (s1 = &b[o]; i; --i, ++s2, ++s1)
           *s2 = *s1;
         *s2++ = '\n';
-        for (s1 = m->b, o = m->l; o; --o, ++s2, ++s1)
+        for (s1 = s, o = n; o; --o, ++s2, ++s1)
           *s2 = *s1;
       }
       *s2++ = '\n';
@@ -76,7 +106,8 @@ chanBlbChnNetconf11Egr(
       pthread_cleanup_pop(1); /* v->free(t) */
     } else
       i = 0;
-    pthread_cleanup_pop(1); /* v->free(m) */
+next:
+    pthread_cleanup_pop(!k); /* free m, unless added */
     if (!i)
       break;
   }
@@ -89,7 +120,6 @@ chanBlbChnNetconf11Igr(
   struct chanBlbIgrCtx *v
 ){
   chanBlb_t *m;
-  chanArr_t p[1];
   unsigned int l;
   unsigned int i0;
   unsigned int i1;
@@ -98,14 +128,10 @@ chanBlbChnNetconf11Igr(
 
   l = v->frmCtx ? (long)v->frmCtx : 0;
   pthread_cleanup_push((void(*)(void*))v->fin, v);
-  p[0].c = v->chan;
-  p[0].v = (void **)&m;
-  p[0].o = chanOpPut;
   m = 0;
   i0 = 0;
   i1 = 0;
-  while ((i = v->blb ? chanBlbIgrBlb(v->free, &v->blb, b + i1, sizeof (b) - i1)
-                     : v->inp(v->inpCtx, b + i1, sizeof (b) - i1)) > 0) {
+  while ((i = chanBlbIgrInp(v, b + i1, sizeof (b) - i1)) > 0) {
     void *tv;
     unsigned int i2;
     unsigned int i3;
@@ -127,7 +153,7 @@ chanBlbChnNetconf11Igr(
       if (!i3) {
         if (b[i2++] != '#'
          || b[i2++] != '\n'
-         || chanOne(0, sizeof (p) / sizeof (p[0]), p) != 1 || p[0].s != chanOsPut)
+         || !chanBlbIgrPut(v, m))
           goto bad;
         m = 0;
         i0 = 0;
@@ -149,8 +175,7 @@ chanBlbChnNetconf11Igr(
         b[i4] = b[i2];
       i1 = i4;
       pthread_cleanup_push((void(*)(void*))v->free, m);
-      for (; i3 && (i = v->blb ? chanBlbIgrBlb(v->free, &v->blb, m->b + i0, i3)
-                             : v->inp(v->inpCtx, m->b + i0, i3)) > 0; i3 -= i, i0 += i);
+      for (; i3 && (i = chanBlbIgrInp(v, m->b + i0, i3)) > 0; i3 -= i, i0 += i);
       pthread_cleanup_pop(0);
       if (i <= 0)
         goto bad;
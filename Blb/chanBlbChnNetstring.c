@@ -27,26 +27,46 @@ void *
 chanBlbChnNetstringEgr(
   struct chanBlbEgrCtx *v
 ){
-  chanBlb_t *m;
+  void *m;
   chanArr_t p[1];
 
   pthread_cleanup_push((void(*)(void*))v->fin, v);
   p[0].c = v->chan;
-  p[0].v = (void **)&m;
+  p[0].v = &m;
   p[0].o = chanOpGet;
-  while (chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+  while (v->outv ? chanBlbEgrGet(v, &m)
+                 : chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+    unsigned char *s;
     unsigned char *t;
+    unsigned int n;
     unsigned int o;
     unsigned int l;
     unsigned int i;
-    unsigned char b[16];
+    int k;
+    unsigned char b[17];
 
-    pthread_cleanup_push((void(*)(void*))v->free, m);
-    for (l = m->l, o = sizeof (b); l && o; l /= 10)
+    pthread_cleanup_push(v->ref ? (void(*)(void*))chanBlbRefFree : (void(*)(void*))v->free, m);
+    s = chanBlbEgrOct(v, m, &n);
+    b[16] = ':';
+    for (l = n, o = 16; l && o; l /= 10)
       b[--o] = l % 10 + '0';
+    k = 0;
     if (!l) {
-      i = sizeof (b) - o;
-      l = i + 1 + m->l + 1;
+      i = 16 - o;
+      if (v->outv) { /* header, octets and trailer gathered */
+        k = i = chanBlbEgrAdd(v, &b[o], i + 1, s, n, ",", 1, m);
+        goto next;
+      }
+      if (v->ref && (t = chanBlbRefGrow(m, i + 1, 1))) { /* header and trailer in place */
+        for (s = t; i; --i, ++s, ++o)
+          *s = b[o];
+        *s = ':';
+        l = ((chanBlbRef_t *)m)->l;
+        *(t + l - 1) = ',';
+        for (o = 0; o < l && (i = v->out(v->outCtx, t + o, l - o)) > 0; o += i);
+        goto next;
+      }
+      l = i + 1 + n + 1;
       if (!(t = v->realloc(0, l)))
         l = 0;
     }
@@ -58,14 +78,15 @@ chanBlbChnNetstringEgr(
       for (s2 = t, s1 = &b[o]; i; --i, ++s2, ++s1)
         *s2 = *s1;
       *s2++ = ':';
-      for (s1 = m->b, o = m->l; o; --o, ++s2, ++s1)
+      for (s1 = s, o = n; o; --o, ++s2, ++s1)
         *s2 = *s1;
       *s2 = ',';
       for (o = 0; o < l && (i = v->out(v->outCtx, t + o, l - o)) > 0; o += i);
       pthread_cleanup_pop(1); /* v->free(t) */
     } else
       i = 0;
-    pthread_cleanup_pop(1); /* v->free(m) */
+next:
+    pthread_cleanup_pop(!k); /* free m, unless added */
     if (!i)
       break;
   }
@@ -78,7 +99,6 @@ chanBlbChnNetstringIgr(
   struct chanBlbIgrCtx *v
 ){
   chanBlb_t *m;
-  chanArr_t p[1];
   unsigned int l;
   unsigned int i0;
   unsigned int i;
@@ -86,12 +106,8 @@ chanBlbChnNetstringIgr(
 
   l = v->frmCtx ? (long)v->frmCtx : 0;
   pthread_cleanup_push((void(*)(void*))v->fin, v);
-  p[0].c = v->chan;
-  p[0].v = (void **)&m;
-  p[0].o = chanOpPut;
   i0 = 0;
-  while ((i = v->blb ? chanBlbIgrBlb(v->free, &v->blb, b + i0, sizeof (b) - i0)
-                     : v->inp(v->inpCtx, b + i0, sizeof (b) - i0)) > 0) {
+  while ((i = chanBlbIgrInp(v, b + i0, sizeof (b) - i0)) > 0) {
     unsigned int i1;
     unsigned int i2;
     unsigned int i3;
@@ -113,13 +129,15 @@ chanBlbChnNetstringIgr(
       b[i2++] = b[i1++];
     i0 = i2;
     pthread_cleanup_push((void(*)(void*))v->free, m);
-    for (i2 = m->l; i3 < i2 && (i = v->blb ? chanBlbIgrBlb(v->free, &v->blb, m->b + i3, i2 - i3)
-                                           : v->inp(v->inpCtx, m->b + i3, i2 - i3)) > 0; i3 += i);
+    for (i2 = m->l; i3 < i2 && (i = chanBlbIgrInp(v, m->b + i3, i2 - i3)) > 0; i3 += i);
     if (i > 0) {
-      if ((i0 && b[--i0] == ',')
-       || (!i0 && (i = v->inp(v->inpCtx, b, 1)) == 1 && b[0] == ','))
-        i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
-      else
+      if (!i0 && (chanBlbIgrInp(v, b, 1)) == 1)
+        i0 = 1;
+      if (i0 && b[0] == ',') {
+        for (--i0, i2 = 0; i2 < i0; ++i2)
+          b[i2] = b[i2 + 1];
+        i = chanBlbIgrPut(v, m);
+      } else
         i = 0;
     } else
       i = 0;
@@ -132,3 +150,58 @@ chanBlbChnNetstringIgr(
   pthread_cleanup_pop(1); /* v->fin(v) */
   return (0);
 }
+
+int
+chanBlbChnNetstringLoopEgr(
+  void *v
+ ,unsigned int l
+ ,unsigned char *h
+ ,unsigned int *hl
+ ,unsigned char *t
+ ,unsigned int *tl
+){
+  unsigned char b[16];
+  unsigned int i;
+
+  for (i = sizeof (b); l && i; l /= 10)
+    b[--i] = l % 10 + '0';
+  if (i == sizeof (b))
+    b[--i] = '0';
+  for (*hl = 0; i < sizeof (b); ++i)
+    h[(*hl)++] = b[i];
+  h[(*hl)++] = ':';
+  t[0] = ',';
+  *tl = 1;
+  return (1);
+  (void)v; /* no context */
+}
+
+long
+chanBlbChnNetstringLoopIgr(
+  void *v
+ ,const unsigned char *b
+ ,unsigned int n
+ ,unsigned int *o
+ ,unsigned int *il
+){
+  unsigned int i;
+  unsigned int l;
+
+  for (i = 0, l = 0; i < n && b[i] <= '9' && b[i] >= '0'; ++i)
+    if (i == 10 || l > (~0U - 9) / 10)
+      return (-1);
+    else
+      l = l * 10 + (b[i] - '0');
+  if (i == n)
+    return (0);
+  if (!i || b[i++] != ':')
+    return (-1);
+  *il = l;
+  if (n - i <= l)
+    return (0);
+  if (b[i + l] != ',')
+    return (-1);
+  *o = i;
+  return (i + l + 1);
+  (void)v; /* no context */
+}
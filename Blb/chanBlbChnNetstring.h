@@ -31,4 +31,24 @@ chanBlbChnNetstringIgr(
   struct chanBlbIgrCtx *v
 );
 
+/* chanBlbLoop framers */
+int
+chanBlbChnNetstringLoopEgr(
+  void *frmCtx
+ ,unsigned int length
+ ,unsigned char *head
+ ,unsigned int *headLength
+ ,unsigned char *tail
+ ,unsigned int *tailLength
+);
+
+long
+chanBlbChnNetstringLoopIgr(
+  void *frmCtx
+ ,const unsigned char *buffer
+ ,unsigned int length
+ ,unsigned int *offset
+ ,unsigned int *itemLength
+);
+
 #endif /* __CHANBLBCHNNETSTRING_H__ */
@@ -399,8 +399,11 @@ chanBlbChnRsecEgr(
   unsigned char *packBuf;
   unsigned char *packSeen;
   unsigned int *frgOff;
-  chanBlb_t *pending;
+  void *pending;
+  void (*pendingFree)(void *);
+  unsigned char *pendingB;
   chanArr_t p[1];
+  unsigned int pendingL;
   unsigned int tagSize;
   unsigned int frgHmacSize;
   unsigned int tableSize;
@@ -432,6 +435,7 @@ chanBlbChnRsecEgr(
   shardCount = 0;
   shardAlloc = 0;
   pending = 0;
+  pendingFree = v->ref ? (void(*)(void*))chanBlbRefFree : v->free;
   lastPackD.tv_sec = 0;
   lastPackD.tv_nsec = 0;
   hasEmit = 0;
@@ -478,7 +482,7 @@ chanBlbChnRsecEgr(
   pthread_cleanup_push(v->fin, v);
   pthread_cleanup_push(egrFinPriv, v);
   p[0].c = v->chan;
-  p[0].v = (void **)&pending;
+  p[0].v = &pending;
   p[0].o = chanOpGet;
 
   for (;;) {
@@ -617,40 +621,41 @@ chanBlbChnRsecEgr(
         struct shardItem *tmp;
 
         /* parse blob prefix: [addrlen(1)][addr(addrlen)][tag(tagSize)][m(1)][delay_us(4)][payload] */
-        if (pending->l < 1) {
+        pendingB = chanBlbEgrOct(v, pending, &pendingL);
+        if (pendingL < 1) {
           /* malformed blob; drop and keep running */
-          v->free(pending);
+          pendingFree(pending);
           pending = 0;
-          p[0].v = (void **)&pending;
+          p[0].v = &pending;
           p[0].o = chanOpGet;
           continue;
         }
-        addrlen = pending->b[0];
+        addrlen = pendingB[0];
         prefixSize = 1 + addrlen + tagSize;
-        if (pending->l < prefixSize + egrhdr) {
+        if (pendingL < prefixSize + egrhdr) {
           /* malformed blob; drop and keep running */
-          v->free(pending);
+          pendingFree(pending);
           pending = 0;
-          p[0].v = (void **)&pending;
+          p[0].v = &pending;
           p[0].o = chanOpGet;
           continue;
         }
-        mVal = pending->b[prefixSize];
-        delayUs = (unsigned long)pending->b[prefixSize + 1] << 24
-                | (unsigned long)pending->b[prefixSize + 2] << 16
-                | (unsigned long)pending->b[prefixSize + 3] << 8
-                | pending->b[prefixSize + 4];
+        mVal = pendingB[prefixSize];
+        delayUs = (unsigned long)pendingB[prefixSize + 1] << 24
+                | (unsigned long)pendingB[prefixSize + 2] << 16
+                | (unsigned long)pendingB[prefixSize + 3] << 8
+                | pendingB[prefixSize + 4];
         delay.tv_sec = delayUs / usps;
         delay.tv_nsec = (long)(delayUs % usps) * 1000L;
-        payloadLen = pending->l - (prefixSize + egrhdr);
+        payloadLen = pendingL - (prefixSize + egrhdr);
 
         /* k bound checked in bytes: the ceiling sum below can wrap
          * when payloadLen is within maxShardSize of UINT_MAX */
         if (payloadLen > 256 * maxShardSize) {
           /* payload exceeds chanBlbChnRsecMax(ctx, 0); drop and keep running */
-          v->free(pending);
+          pendingFree(pending);
           pending = 0;
-          p[0].v = (void **)&pending;
+          p[0].v = &pending;
           p[0].o = chanOpGet;
           continue;
         }
@@ -689,9 +694,9 @@ chanBlbChnRsecEgr(
           + mVal * sizeof (unsigned char *));
         if (!dataPtrs) {
           /* drop blob and keep running */
-          v->free(pending);
+          pendingFree(pending);
           pending = 0;
-          p[0].v = (void **)&pending;
+          p[0].v = &pending;
           p[0].o = chanOpGet;
           continue;
         }
@@ -700,15 +705,15 @@ chanBlbChnRsecEgr(
         work = v->realloc(0, (unsigned long)km * stride);
         if (!work) {
           v->free(dataPtrs);
-          v->free(pending);
+          pendingFree(pending);
           pending = 0;
-          p[0].v = (void **)&pending;
+          p[0].v = &pending;
           p[0].o = chanOpGet;
           continue;
         }
 
         /* build header template in first slot */
-        memcpy(work, pending->b, prefixSize); /* [addrlen][addr][tag] common prefix */
+        memcpy(work, pendingB, prefixSize); /* [addrlen][addr][tag] common prefix */
         work[prefixSize] = (k - 1);       /* k-1 on wire */
         work[prefixSize + 1] = mVal;                     /* m */
         work[prefixSize + 2] = 0;                        /* shard_index placeholder */
@@ -733,7 +738,7 @@ chanBlbChnRsecEgr(
             if (len > msgShardSize)
               len = msgShardSize;
             if (len > 0)
-              memcpy(s + headerGap, pending->b + prefixSize + egrhdr + off, len);
+              memcpy(s + headerGap, pendingB + prefixSize + egrhdr + off, len);
             if (len < msgShardSize)
               memset(s + headerGap + len, 0, msgShardSize - len);
             dataPtrs[i] = s + headerGap;
@@ -748,9 +753,9 @@ chanBlbChnRsecEgr(
           /* unexpected encode failure: drop and keep running */
           v->free(dataPtrs);
           v->free(work);
-          v->free(pending);
+          pendingFree(pending);
           pending = 0;
-          p[0].v = (void **)&pending;
+          p[0].v = &pending;
           p[0].o = chanOpGet;
           continue;
         }
@@ -771,7 +776,7 @@ chanBlbChnRsecEgr(
               s + wp, headerGap + msgShardSize - wp);
         }
 
-        v->free(pending);
+        pendingFree(pending);
         pending = 0;
 
         /* store in table */
@@ -789,7 +794,7 @@ chanBlbChnRsecEgr(
             /* drop this message and keep running (pending already freed) */
             v->free(table[slot].work);
             table[slot].work = 0;
-            p[0].v = (void **)&pending;
+            p[0].v = &pending;
             p[0].o = chanOpGet;
             continue;
           }
@@ -814,14 +819,14 @@ chanBlbChnRsecEgr(
         }
 
         /* resume gets */
-        p[0].v = (void **)&pending;
+        p[0].v = &pending;
         p[0].o = chanOpGet;
       }
     }
   }
 
 exit:
-  v->free(pending);
+  pendingFree(pending);
   for (ti = 0; ti < tableSize; ++ti) {
     if (table[ti].work)
       v->free(table[ti].work);
@@ -895,7 +900,6 @@ chanBlbChnRsecIgr(
   unsigned char *buf;
   unsigned char *hdr;
   unsigned int *frgOff;
-  chanArr_t p[1];
   unsigned int tagSize;
   unsigned int tableSize;
   unsigned int frgHmacSize;
@@ -956,9 +960,6 @@ chanBlbChnRsecIgr(
 
   pthread_cleanup_push(v->fin, v);
   pthread_cleanup_push(igrFinPriv, v);
-  p[0].c = v->chan;
-  p[0].v = 0;
-  p[0].o = chanOpPut;
   tableUsed = 0;
   age = 0;
 
@@ -1161,9 +1162,7 @@ chanBlbChnRsecIgr(
             lb->b[table[slot]->prefixSize - igrhdr] = 0;
             lb->b[table[slot]->prefixSize - igrhdr + 1] =
               table[slot]->received;
-            p[0].v = (void **)&lb;
-            if (chanOne(0, sizeof (p) / sizeof (p[0]), p) != 1
-             || p[0].s != chanOsPut)
+            if (!chanBlbIgrPut(v, lb))
               v->free(lb);
           }
           v->free(table[slot]);
@@ -1238,9 +1237,7 @@ chanBlbChnRsecIgr(
             lb->b[table[lruIdx]->prefixSize - igrhdr] = 0;
             lb->b[table[lruIdx]->prefixSize - igrhdr + 1] =
               table[lruIdx]->received;
-            p[0].v = (void **)&lb;
-            if (chanOne(0, sizeof (p) / sizeof (p[0]), p) != 1
-             || p[0].s != chanOsPut)
+            if (!chanBlbIgrPut(v, lb))
               v->free(lb);
           }
           v->free(table[lruIdx]);
@@ -1443,9 +1440,7 @@ chanBlbChnRsecIgr(
       }
 
       /* put blob on channel */
-      p[0].v = (void **)&ent->blob;
-      if (chanOne(0, sizeof (p) / sizeof (p[0]), p) != 1
-       || p[0].s != chanOsPut) {
+      if (!chanBlbIgrPut(v, ent->blob)) {
         v->free(ent->blob);
         v->free(ent);
         --tableUsed;
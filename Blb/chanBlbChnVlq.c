@@ -27,42 +27,56 @@ void *
 chanBlbChnVlqEgr(
   struct chanBlbEgrCtx *v
 ){
-  chanBlb_t *m;
+  void *m;
   chanArr_t p[1];
 
   pthread_cleanup_push((void(*)(void*))v->fin, v);
   p[0].c = v->chan;
-  p[0].v = (void **)&m;
+  p[0].v = &m;
   p[0].o = chanOpGet;
-  while (chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+  while (v->outv ? chanBlbEgrGet(v, &m)
+                 : chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsGet) {
+    unsigned char *s;
     unsigned char *t;
+    unsigned int n;
     unsigned int o;
     unsigned int l;
     unsigned int i;
+    int k;
     unsigned char b[16];
 
-    pthread_cleanup_push((void(*)(void*))v->free, m);
-    b[(i = sizeof (b) - 1)] = (l = m->l) & 0x7f;
+    pthread_cleanup_push(v->ref ? (void(*)(void*))chanBlbRefFree : (void(*)(void*))v->free, m);
+    s = chanBlbEgrOct(v, m, &n);
+    b[(i = sizeof (b) - 1)] = (l = n) & 0x7f;
     while (l >>= 7)
       b[--i] = 0x80 | (--l & 0x7f);
     o = sizeof (b) - i;
-    l = o + m->l;
-    if (!(t = v->realloc(0, l)))
-      l = 0;
-    if (l) {
-      unsigned char *s1;
-      unsigned char *s2;
+    k = 0;
+    if (v->outv) /* header and octets gathered */
+      k = i = chanBlbEgrAdd(v, &b[i], o, s, n, 0, 0, m);
+    else if (v->ref && (t = chanBlbRefGrow(m, o, 0))) { /* header in place */
+      for (s = t; o; --o, ++s, ++i)
+        *s = b[i];
+      for (l = ((chanBlbRef_t *)m)->l, o = 0; o < l && (i = v->out(v->outCtx, t + o, l - o)) > 0; o += i);
+    } else {
+      l = o + n;
+      if (!(t = v->realloc(0, l)))
+        l = 0;
+      if (l) {
+        unsigned char *s1;
+        unsigned char *s2;
 
-      pthread_cleanup_push((void(*)(void*))v->free, t);
-      for (s2 = t, s1 = &b[i]; o; --o, ++s2, ++s1)
-        *s2 = *s1;
-      for (s1 = m->b, o = m->l; o; --o, ++s2, ++s1)
-        *s2 = *s1;
-      for (o = 0; o < l && (i = v->out(v->outCtx, t + o, l - o)) > 0; o += i);
-      pthread_cleanup_pop(1); /* v->free(t) */
-    } else
-      i = 0;
-    pthread_cleanup_pop(1); /* v->free(m) */
+        pthread_cleanup_push((void(*)(void*))v->free, t);
+        for (s2 = t, s1 = &b[i]; o; --o, ++s2, ++s1)
+          *s2 = *s1;
+        for (s1 = s, o = n; o; --o, ++s2, ++s1)
+          *s2 = *s1;
+        for (o = 0; o < l && (i = v->out(v->outCtx, t + o, l - o)) > 0; o += i);
+        pthread_cleanup_pop(1); /* v->free(t) */
+      } else
+        i = 0;
+    }
+    pthread_cleanup_pop(!k); /* free m, unless added */
     if (!i)
       break;
   }
@@ -75,7 +89,6 @@ chanBlbChnVlqIgr(
   struct chanBlbIgrCtx *v
 ){
   chanBlb_t *m;
-  chanArr_t p[1];
   unsigned int l;
   unsigned int i0;
   unsigned int i;
@@ -83,12 +96,8 @@ chanBlbChnVlqIgr(
 
   l = v->frmCtx ? (long)v->frmCtx : 0;
   pthread_cleanup_push((void(*)(void*))v->fin, v);
-  p[0].c = v->chan;
-  p[0].v = (void **)&m;
-  p[0].o = chanOpPut;
   i0 = 0;
-  while ((i = v->blb ? chanBlbIgrBlb(v->free, &v->blb, b + i0, sizeof (b) - i0)
-                     : v->inp(v->inpCtx, b + i0, sizeof (b) - i0)) > 0) {
+  while ((i = chanBlbIgrInp(v, b + i0, sizeof (b) - i0)) > 0) {
     unsigned int i1;
     unsigned int i2;
     unsigned int i3;
@@ -112,10 +121,9 @@ chanBlbChnVlqIgr(
       b[i2++] = b[i1++];
     i0 = i2;
     pthread_cleanup_push((void(*)(void*))v->free, m);
-    for (i2 = m->l; i3 < i2 && (i = v->blb ? chanBlbIgrBlb(v->free, &v->blb, m->b + i3, i2 - i3)
-                                           : v->inp(v->inpCtx, m->b + i3, i2 - i3)) > 0; i3 += i);
+    for (i2 = m->l; i3 < i2 && (i = chanBlbIgrInp(v, m->b + i3, i2 - i3)) > 0; i3 += i);
     if (i > 0)
-      i = chanOne(0, sizeof (p) / sizeof (p[0]), p) == 1 && p[0].s == chanOsPut;
+      i = chanBlbIgrPut(v, m);
     pthread_cleanup_pop(0); /* v->free(m) */
     if (!i) {
       v->free(m);
@@ -126,3 +134,53 @@ done:
   pthread_cleanup_pop(1); /* v->fin(v) */
   return (0);
 }
+
+int
+chanBlbChnVlqLoopEgr(
+  void *v
+ ,unsigned int l
+ ,unsigned char *h
+ ,unsigned int *hl
+ ,unsigned char *t
+ ,unsigned int *tl
+){
+  unsigned char b[16];
+  unsigned int i;
+
+  b[(i = sizeof (b) - 1)] = l & 0x7f;
+  while (l >>= 7)
+    b[--i] = 0x80 | (--l & 0x7f);
+  for (*hl = 0; i < sizeof (b); ++i)
+    h[(*hl)++] = b[i];
+  *tl = 0;
+  return (1);
+  (void)v; /* no context */
+  (void)t; /* no tail */
+}
+
+long
+chanBlbChnVlqLoopIgr(
+  void *v
+ ,const unsigned char *b
+ ,unsigned int n
+ ,unsigned int *o
+ ,unsigned int *il
+){
+  unsigned int i;
+  unsigned int l;
+
+  if (!n)
+    return (0);
+  for (i = 0, l = b[0] & 0x7f; b[i] & 0x80; l = (l << 7) | (b[i] & 0x7f)) {
+    if (!++l || l >> ((sizeof (l) - 1) * 8 + 1))
+      return (-1);
+    if (++i == n)
+      return (0);
+  }
+  *il = l;
+  if (n - ++i < l)
+    return (0);
+  *o = i;
+  return (i + l);
+  (void)v; /* no context */
+}
@@ -31,4 +31,24 @@ chanBlbChnVlqIgr(
   struct chanBlbIgrCtx *v
 );
 
+/* chanBlbLoop framers */
+int
+chanBlbChnVlqLoopEgr(
+  void *frmCtx
+ ,unsigned int length
+ ,unsigned char *head
+ ,unsigned int *headLength
+ ,unsigned char *tail
+ ,unsigned int *tailLength
+);
+
+long
+chanBlbChnVlqLoopIgr(
+  void *frmCtx
+ ,const unsigned char *buffer
+ ,unsigned int length
+ ,unsigned int *offset
+ ,unsigned int *itemLength
+);
+
 #endif /* __CHANBLBCHNVLQ_H__ */
@@ -0,0 +1,697 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "chan.h"
+#include "chanBlb.h"
+#include "chanBlbLoop.h"
+
+#define LOOPEGR 8     /* items per writev() */
+#define LOOPIGR 65536 /* octets per read() */
+#define LOOPEVT 64    /* events per epoll_wait() */
+
+struct con;
+
+/* loop thread */
+struct thr {
+  struct chanBlbLoop *p;
+  struct con *c;      /* connections */
+  struct con *r;      /* ready (noted) connections */
+  struct con *a;      /* connection being run */
+  struct con *d;      /* ended connections, freed after events */
+  unsigned char *b;   /* read buffer */
+  pthread_mutex_t m;
+  pthread_t t;
+  int e;              /* epoll */
+  int n;              /* eventfd */
+  int q;              /* quit */
+};
+
+struct chanBlbLoop {
+  void *(*ma)(void *, unsigned long);
+  void (*mf)(void *);
+  unsigned int n;     /* threads */
+  unsigned int i;     /* next thread */
+  struct thr t[1];
+};
+
+/* connection */
+struct con {
+  struct thr *t;
+  struct con *n;      /* next connection */
+  struct con *p;      /* previous connection */
+  struct con *r;      /* next ready connection */
+  chan_t *cE;
+  chan_t *cI;
+  chanBlbLoopEgr_t fE;
+  chanBlbLoopIgr_t fI;
+  void *xE;
+  void *xI;
+  void *f;
+  void (*fc)(void *);
+  unsigned char *b;   /* ingress octets buffered */
+  void *m;            /* ingress item to Put */
+  unsigned int bs;    /* buffer size */
+  unsigned int bn;    /* buffer octets */
+  unsigned int mx;    /* ingress item maximum */
+  unsigned int en;    /* egress items */
+  int ev;             /* egress iovec being output */
+  int ec;             /* egress iovecs */
+  int fd;
+  unsigned char rE;   /* egress items are chanBlbRef_t */
+  unsigned char rI;   /* ingress items are chanBlbRef_t */
+  unsigned char dE;   /* egress done */
+  unsigned char dI;   /* ingress done */
+  unsigned char sE;   /* egress Get shutdown, done after output */
+  unsigned char ri;   /* may read */
+  unsigned char wo;   /* may write */
+  unsigned char rq;   /* on ready list */
+  unsigned char ag;   /* noted while run */
+  unsigned char hd;   /* held, not run while being added */
+  void *em[LOOPEGR];
+  struct iovec v[LOOPEGR * 3];
+  unsigned char h[LOOPEGR][32];
+};
+
+/* chanNote, under the Channel's lock */
+static void
+note(
+  void *v
+#define V ((struct con *)v)
+){
+  struct thr *t;
+  unsigned long long o;
+  int k;
+
+  t = V->t;
+  k = 0;
+  pthread_mutex_lock(&t->m);
+  if (t->a == V)
+    V->ag = 1;
+  else if (!V->rq) {
+    V->rq = 1;
+    k = !t->r;
+    V->r = t->r;
+    t->r = V;
+  }
+  pthread_mutex_unlock(&t->m);
+  if (k) {
+    o = 1;
+    if (write(t->n, &o, sizeof (o)) < 0) {} /* full is still readable */
+  }
+#undef V
+}
+
+static void
+rel(
+  struct con *x
+ ,int r
+ ,void *m
+){
+  if (r)
+    chanBlbRefFree(m);
+  else
+    x->t->p->mf(m);
+}
+
+/* return 0 when egress is done */
+static int
+egr(
+  struct con *x
+){
+  for (;;) {
+    void *m;
+    unsigned char *s;
+    unsigned int n;
+    unsigned int hl;
+    unsigned int tl;
+    long r;
+
+    if (x->ev < x->ec) {
+      if (!x->wo)
+        return (1);
+      if ((r = writev(x->fd, x->v + x->ev, x->ec - x->ev)) < 0) {
+        if (errno == EINTR)
+          continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          x->wo = 0;
+          return (1);
+        }
+        return (0);
+      }
+      for (; x->ev < x->ec && (unsigned long)r >= (x->v + x->ev)->iov_len; r -= (x->v + x->ev)->iov_len, ++x->ev);
+      if (x->ev < x->ec) {
+        (x->v + x->ev)->iov_base = (unsigned char *)(x->v + x->ev)->iov_base + r;
+        (x->v + x->ev)->iov_len -= r;
+      }
+      continue;
+    }
+    while (x->en)
+      rel(x, x->rE, x->em[--x->en]);
+    x->ev = x->ec = 0;
+    if (x->sE)
+      return (0);
+    while (x->en < LOOPEGR) {
+      switch (chanOp(-1, x->cE, &m, chanOpGet)) {
+      case chanOsGet:
+        break;
+      case chanOsTmo:
+        goto gathered;
+      default:
+        x->sE = 1;
+        goto gathered;
+      }
+      if (x->rE) {
+        s = ((chanBlbRef_t *)m)->b;
+        n = ((chanBlbRef_t *)m)->l;
+      } else {
+        s = ((chanBlb_t *)m)->b;
+        n = ((chanBlb_t *)m)->l;
+      }
+      hl = tl = 0;
+      if (x->fE && !x->fE(x->xE, n, x->h[x->en], &hl, x->h[x->en] + 16, &tl)) {
+        rel(x, x->rE, m);
+        x->sE = 1;
+        break;
+      }
+      if (hl) {
+        (x->v + x->ec)->iov_base = x->h[x->en];
+        (x->v + x->ec++)->iov_len = hl;
+      }
+      if (n) {
+        (x->v + x->ec)->iov_base = s;
+        (x->v + x->ec++)->iov_len = n;
+      }
+      if (tl) {
+        (x->v + x->ec)->iov_base = x->h[x->en] + 16;
+        (x->v + x->ec++)->iov_len = tl;
+      }
+      x->em[x->en++] = m;
+    }
+gathered:
+    if (!x->en)
+      return (!x->sE);
+  }
+}
+
+/* Put the ingress item, return 1 if Put (or none), 0 to wait, -1 when shutdown */
+static int
+put(
+  struct con *x
+){
+  if (!x->m)
+    return (1);
+  switch (chanOp(-1, x->cI, &x->m, chanOpPut)) {
+  case chanOsPut:
+    x->m = 0;
+    return (1);
+  case chanOsTmo:
+    return (0);
+  default:
+    return (-1);
+  }
+}
+
+/* cut the next ingress item from buffered octets, return octets consumed, 0 for more or -1 on failure */
+static long
+cut(
+  struct con *x
+ ,const unsigned char *b
+ ,unsigned int n
+){
+  unsigned int o;
+  unsigned int l;
+  long r;
+
+  if (x->fI) {
+    l = 0;
+    if ((r = x->fI(x->xI, b, n, &o, &l)) <= 0)
+      return (r < 0 || l > x->mx ? -1 : 0);
+    if (l > x->mx)
+      return (-1);
+  } else {
+    o = 0;
+    r = l = n < x->mx ? n : x->mx;
+  }
+  if (x->rI) {
+    chanBlbRef_t *m;
+
+    if (!(m = chanBlbRefNew(x->t->p->ma, x->t->p->mf, 0, l, 0)))
+      return (-1);
+    memcpy(m->b, b + o, l);
+    x->m = m;
+  } else {
+    chanBlb_t *m;
+
+    if (!(m = x->t->p->ma(0, chanBlb_tSize(l))))
+      return (-1);
+    m->l = l;
+    memcpy(m->b, b + o, l);
+    x->m = m;
+  }
+  return (r);
+}
+
+/* return 0 when ingress is done */
+static int
+igr(
+  struct thr *t
+ ,struct con *x
+){
+  for (;;) {
+    unsigned char *b;
+    unsigned int n;
+    long r;
+    int k;
+
+    if ((k = put(x)) <= 0)
+      return (k + 1);
+    if (x->bn) {
+      if ((r = cut(x, x->b, x->bn)) < 0)
+        return (0);
+      if (r) {
+        if ((x->bn -= r))
+          memmove(x->b, x->b + r, x->bn);
+        continue;
+      }
+      if (x->bn == x->bs) {
+        if (!(b = t->p->ma(x->b, x->bs * 2)))
+          return (0);
+        x->b = b;
+        x->bs *= 2;
+      }
+    }
+    if (!x->ri)
+      return (1);
+    if (x->bn)
+      r = read(x->fd, (b = x->b + x->bn), x->bs - x->bn);
+    else
+      r = read(x->fd, (b = t->b), LOOPIGR);
+    if (r < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        x->ri = 0;
+        return (1);
+      }
+      return (0);
+    }
+    if (!r)
+      return (0);
+    if (x->bn) {
+      x->bn += r;
+      continue;
+    }
+    /* cut in place, buffer what remains */
+    for (n = r; n; b += r, n -= r) {
+      if ((k = put(x)) < 0)
+        return (0);
+      if (!k || !(r = cut(x, b, n)))
+        break;
+      if (r < 0)
+        return (0);
+    }
+    if (n) {
+      if (x->bs < n * 2) {
+        t->p->mf(x->b);
+        x->bs = n * 2 < 4096 ? 4096 : n * 2;
+        if (!(x->b = t->p->ma(0, x->bs))) {
+          x->bs = 0;
+          return (0);
+        }
+      }
+      memcpy(x->b, b, n);
+      x->bn = n;
+    }
+  }
+}
+
+/* end a connection, freed after events */
+static void
+end(
+  struct thr *t
+ ,struct con *x
+){
+  struct con **y;
+
+  chanNote(x->cE, 0, 0);
+  chanNote(x->cI, 0, 0);
+  epoll_ctl(t->e, EPOLL_CTL_DEL, x->fd, 0);
+  close(x->fd);
+  pthread_mutex_lock(&t->m);
+  if (x->n)
+    x->n->p = x->p;
+  if (x->p)
+    x->p->n = x->n;
+  else
+    t->c = x->n;
+  if (x->rq)
+    for (y = &t->r; *y; y = &(*y)->r)
+      if (*y == x) {
+        *y = x->r;
+        break;
+      }
+  pthread_mutex_unlock(&t->m);
+  while (x->en)
+    rel(x, x->rE, x->em[--x->en]);
+  if (x->m)
+    rel(x, x->rI, x->m);
+  t->p->mf(x->b);
+  chanClose(x->cE);
+  chanClose(x->cI);
+  if (x->fc)
+    x->fc(x->f);
+  x->n = t->d;
+  t->d = x;
+}
+
+static void
+run(
+  struct thr *t
+ ,struct con *x
+){
+  int k;
+
+  pthread_mutex_lock(&t->m);
+  if (x->hd) {
+    pthread_mutex_unlock(&t->m);
+    return;
+  }
+  t->a = x;
+  pthread_mutex_unlock(&t->m);
+  do {
+    if (!x->dE && !egr(x)) {
+      x->dE = 1;
+      chanShut(x->cE);
+      shutdown(x->fd, SHUT_WR);
+    }
+    if (!x->dI && !igr(t, x)) {
+      x->dI = 1;
+      chanShut(x->cI);
+    }
+    pthread_mutex_lock(&t->m);
+    k = x->ag;
+    x->ag = 0;
+    if (!k || (x->dE && x->dI))
+      t->a = 0;
+    pthread_mutex_unlock(&t->m);
+  } while (k && !(x->dE && x->dI));
+  if (x->dE && x->dI)
+    end(t, x);
+}
+
+static void *
+thrT(
+  void *v
+#define V ((struct thr *)v)
+){
+  struct con *x;
+  int i;
+  int n;
+  int q;
+  struct epoll_event e[LOOPEVT];
+
+  for (q = 0; !q;) {
+    if ((n = epoll_wait(V->e, e, sizeof (e) / sizeof (e[0]), -1)) < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    for (i = 0; i < n; ++i) {
+      if (!(x = e[i].data.ptr)) {
+        unsigned long long o;
+
+        if (read(V->n, &o, sizeof (o)) < 0) {} /* drained below */
+        for (;;) {
+          pthread_mutex_lock(&V->m);
+          while ((x = V->r)) {
+            V->r = x->r;
+            x->rq = 0;
+            if (!x->hd)
+              break;
+          }
+          q = V->q;
+          pthread_mutex_unlock(&V->m);
+          if (!x)
+            break;
+          run(V, x);
+        }
+        continue;
+      }
+      if (x->dE && x->dI)
+        continue;
+      if (e[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+        x->ri = 1;
+      if (e[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+        x->wo = 1;
+      run(V, x);
+    }
+    while ((x = V->d)) {
+      V->d = x->n;
+      V->p->mf(x);
+    }
+  }
+  while ((x = V->c)) {
+    chanShut(x->cE);
+    chanShut(x->cI);
+    x->dE = x->dI = 1;
+    end(V, x);
+  }
+  while ((x = V->d)) {
+    V->d = x->n;
+    V->p->mf(x);
+  }
+  return (0);
+#undef V
+}
+
+chanBlbLoop_t *
+chanBlbLoopNew(
+  void *(*ma)(void *, unsigned long)
+ ,void (*mf)(void *)
+ ,unsigned int n
+ ,pthread_attr_t *a
+){
+  struct chanBlbLoop *p;
+  struct thr *t;
+  struct epoll_event e;
+
+  if (!ma || !mf)
+    return (0);
+  if (!n)
+    n = 1;
+  if (!(p = ma(0, sizeof (*p) + (n - 1) * sizeof (p->t[0]))))
+    return (0);
+  p->ma = ma;
+  p->mf = mf;
+  p->i = 0;
+  for (p->n = 0; p->n < n; ++p->n) {
+    t = p->t + p->n;
+    t->p = p;
+    t->c = t->r = t->a = t->d = 0;
+    t->q = 0;
+    if (!(t->b = ma(0, LOOPIGR)))
+      goto error;
+    if ((t->e = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+      mf(t->b);
+      goto error;
+    }
+    if ((t->n = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+      close(t->e);
+      mf(t->b);
+      goto error;
+    }
+    e.events = EPOLLIN;
+    e.data.ptr = 0;
+    if (epoll_ctl(t->e, EPOLL_CTL_ADD, t->n, &e)
+     || pthread_mutex_init(&t->m, 0)) {
+      close(t->n);
+      close(t->e);
+      mf(t->b);
+      goto error;
+    }
+    if (pthread_create(&t->t, a, thrT, t)) {
+      pthread_mutex_destroy(&t->m);
+      close(t->n);
+      close(t->e);
+      mf(t->b);
+      goto error;
+    }
+  }
+  return (p);
+error:
+  chanBlbLoopDel(p);
+  return (0);
+}
+
+int
+chanBlbLoopAdd(
+  chanBlbLoop_t *p
+ ,int fd
+ ,chan_t *e
+ ,void *ex
+ ,chanBlbLoopEgr_t ef
+ ,int er
+ ,chan_t *i
+ ,void *ix
+ ,chanBlbLoopIgr_t ig
+ ,int ir
+ ,unsigned int mx
+ ,void *f
+ ,void (*fc)(void *)
+){
+  struct con *x;
+  struct con **y;
+  struct thr *t;
+  int l;
+  struct epoll_event v;
+
+  if (!p || fd < 0 || (!e && !i))
+    goto error;
+  if ((l = fcntl(fd, F_GETFL)) < 0
+   || fcntl(fd, F_SETFL, l | O_NONBLOCK) < 0
+   || !(x = p->ma(0, sizeof (*x))))
+    goto error;
+  t = p->t + __atomic_fetch_add(&p->i, 1, __ATOMIC_RELAXED) % p->n;
+  x->t = t;
+  x->r = 0;
+  x->cE = chanOpen(e);
+  x->cI = chanOpen(i);
+  x->fE = ef;
+  x->fI = ig;
+  x->xE = ex;
+  x->xI = ix;
+  x->f = f;
+  x->fc = fc;
+  x->b = 0;
+  x->m = 0;
+  x->bs = x->bn = 0;
+  x->mx = mx ? mx : 65536;
+  x->en = 0;
+  x->ev = x->ec = 0;
+  x->fd = fd;
+  x->rE = er ? 1 : 0;
+  x->rI = ir ? 1 : 0;
+  x->dE = !e;
+  x->dI = !i;
+  x->sE = 0;
+  x->ri = x->wo = 1;
+  x->rq = x->ag = 0;
+  x->hd = 1;
+  if (!e)
+    shutdown(fd, SHUT_WR);
+  if (!i)
+    shutdown(fd, SHUT_RD);
+  pthread_mutex_lock(&t->m);
+  x->p = 0;
+  if ((x->n = t->c))
+    x->n->p = x;
+  t->c = x;
+  pthread_mutex_unlock(&t->m);
+  /* noted and polled while held, then released to a first run */
+  chanNote(x->cE, note, x);
+  chanNote(x->cI, note, x);
+  v.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+  v.data.ptr = x;
+  if (epoll_ctl(t->e, EPOLL_CTL_ADD, fd, &v)) {
+    chanNote(x->cE, 0, 0);
+    chanNote(x->cI, 0, 0);
+    pthread_mutex_lock(&t->m);
+    if (x->n)
+      x->n->p = x->p;
+    if (x->p)
+      x->p->n = x->n;
+    else
+      t->c = x->n;
+    if (x->rq)
+      for (y = &t->r; *y; y = &(*y)->r)
+        if (*y == x) {
+          *y = x->r;
+          break;
+        }
+    pthread_mutex_unlock(&t->m);
+    chanClose(x->cE);
+    chanClose(x->cI);
+    p->mf(x);
+    goto error;
+  }
+  pthread_mutex_lock(&t->m);
+  x->hd = 0;
+  l = 0;
+  if (!x->rq) {
+    x->rq = 1;
+    l = !t->r;
+    x->r = t->r;
+    t->r = x;
+  }
+  pthread_mutex_unlock(&t->m);
+  if (l) {
+    unsigned long long o;
+
+    o = 1;
+    if (write(t->n, &o, sizeof (o)) < 0) {} /* full is still readable */
+  }
+  return (1);
+error:
+  if (fd >= 0)
+    close(fd);
+  chanShut(e);
+  chanShut(i);
+  if (fc)
+    fc(f);
+  return (0);
+}
+
+void
+chanBlbLoopDel(
+  chanBlbLoop_t *p
+){
+  struct thr *t;
+  unsigned long long o;
+  unsigned int i;
+
+  if (!p)
+    return;
+  for (i = 0; i < p->n; ++i) {
+    t = p->t + i;
+    pthread_mutex_lock(&t->m);
+    t->q = 1;
+    pthread_mutex_unlock(&t->m);
+    o = 1;
+    if (write(t->n, &o, sizeof (o)) < 0) {} /* full is still readable */
+  }
+  for (i = 0; i < p->n; ++i) {
+    t = p->t + i;
+    pthread_join(t->t, 0);
+    pthread_mutex_destroy(&t->m);
+    close(t->n);
+    close(t->e);
+    p->mf(t->b);
+  }
+  p->mf(p);
+}
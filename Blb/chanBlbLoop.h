@@ -0,0 +1,121 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANBLBLOOP_H__
+#define __CHANBLBLOOP_H__
+
+/* Channel Blob event loop (Linux epoll and eventfd)
+ *
+ * A chanBlb() bridge costs two threads per fd. A loop serves many fds with a fixed pool of threads,
+ * each waiting in epoll_wait() for its (non-blocking) fds and, by chanNote(), for its Channels.
+ * Framers run on the loop thread, as functions of what is buffered, so they never block.
+ */
+typedef struct chanBlbLoop chanBlbLoop_t;
+
+/* loop egress framer, set the head and tail (at most 16 octets each) output around an item's octets
+ *  return 0 on failure
+ */
+typedef int
+(*chanBlbLoopEgr_t)(
+  void *frmCtx
+ ,unsigned int length
+ ,unsigned char *head
+ ,unsigned int *headLength
+ ,unsigned char *tail
+ ,unsigned int *tailLength
+);
+
+/* loop ingress framer, given the octets buffered so far
+ *  return the octets consumed by the next item, setting the item's offset and length within them
+ *  else return 0 when more are needed (setting length to the item's when known), or -1 on failure
+ */
+typedef long
+(*chanBlbLoopIgr_t)(
+  void *frmCtx
+ ,const unsigned char *buffer
+ ,unsigned int length
+ ,unsigned int *offset
+ ,unsigned int *itemLength
+);
+
+/* return a loop of threads (0 for 1) or 0 on failure */
+chanBlbLoop_t *
+chanBlbLoopNew(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,unsigned int threads
+ ,pthread_attr_t *attr
+);
+
+/* Channel Blob on a loop
+ *
+ * Like chanBlb(), on one full-duplex fd (set non-blocking), with items chanBlbRef_t if the Ref is non-zero, else chanBlb_t
+ *
+ * Provide an optional egress chan_t: (if not provided, the fd is shutdown(SHUT_WR) immediately)
+ * Provide an optional egress framer context and framer (without one, items are output as is)
+ * Provide an optional ingress chan_t: (if not provided, the fd is shutdown(SHUT_RD) immediately)
+ * Provide an optional ingress framer context and framer (without one, an item per read)
+ * Provide the maximum octets per ingress item (0 for 65536)
+ * Provide an optional finalCtx and finalClose()
+ *
+ * A chanOpPut on the egress channel, while the fd can be written, outputs up to 8 items per writev()
+ *  A Get shutdown or output failure will chanShut(egress) and shutdown(fd, SHUT_WR).
+ * A chanOpGet on the ingress channel will return items read
+ *  A Put shutdown, read end or failure will chanShut(ingress).
+ * After both, the fd is closed, the Channels closed and, if provided, finalClose(finalCtx) is invoked
+ *
+ * NOTE: a Channel has one chanNote(), so it can't be on two loop fds (or otherwise noted)
+ *
+ * On success:
+ *  return non-zero
+ * On failure:
+ *  the fd is closed
+ *  channels are chanShut()
+ *  finalClose(finalCtx) is invoked
+ *  return 0
+ */
+int
+chanBlbLoopAdd(
+  chanBlbLoop_t *loop
+ ,int fd
+
+ ,chan_t *egress
+ ,void *egressFrmCtx
+ ,chanBlbLoopEgr_t egressFrm
+ ,int egressRef
+
+ ,chan_t *ingress
+ ,void *ingressFrmCtx
+ ,chanBlbLoopIgr_t ingressFrm
+ ,int ingressRef
+ ,unsigned int ingressMax
+
+ ,void *finalCtx
+ ,void (*finalClose)(void *finalCtx)
+);
+
+/* shut and close every fd on a loop (as if on failure) and end its threads */
+/* calling with 0 is a harmless no-op */
+void
+chanBlbLoopDel(
+  chanBlbLoop_t *loop
+);
+
+#endif /* __CHANBLBLOOP_H__ */
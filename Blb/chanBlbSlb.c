@@ -0,0 +1,247 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "chanBlbSlb.h"
+
+#define SLBMIN 5   /* smallest size class, 1 << SLBMIN octets */
+#define SLBMAX 17  /* largest size class, 1 << SLBMAX octets */
+#define SLBBYT 20  /* cache up to 1 << SLBBYT octets per size class */
+
+struct thr;
+
+struct hdr { /* precedes each block */
+  struct thr *o;   /* allocating thread cache, 0 if passed through */
+  unsigned long c; /* size class, else size */
+};
+
+struct blk { /* a cached block */
+  struct hdr h;
+  struct blk *n;
+};
+
+struct thr { /* thread cache */
+  struct blk *l[SLBMAX - SLBMIN + 1];  /* free lists by size class */
+  unsigned int n[SLBMAX - SLBMIN + 1]; /* free list lengths */
+  struct blk *r;                       /* return list, pushed by other threads */
+  unsigned long u;                     /* blocks not released, plus one while the thread lives */
+};
+
+/* return list of an exited thread */
+#define DEAD ((struct blk *)1)
+
+static pthread_key_t Key;
+
+static void
+rls(
+  struct thr *t
+ ,unsigned long n
+){
+  if (!__atomic_sub_fetch(&t->u, n, __ATOMIC_ACQ_REL))
+    free(t);
+}
+
+static void
+thrFin(
+  void *v
+){
+#define V ((struct thr *)v)
+  struct blk *b;
+  struct blk *n;
+  unsigned long c;
+  unsigned int i;
+
+  c = 1;
+  for (i = 0; i < sizeof (V->l) / sizeof (V->l[0]); ++i)
+    for (b = V->l[i]; b; b = n, ++c) {
+      n = b->n;
+      free(b);
+    }
+  for (b = __atomic_exchange_n(&V->r, DEAD, __ATOMIC_ACQUIRE); b; b = n, ++c) {
+    n = b->n;
+    free(b);
+  }
+  rls(V, c);
+#undef V
+}
+
+static void
+thrKey(
+  void
+){
+  pthread_key_create(&Key, thrFin);
+}
+
+static struct thr *
+thr(
+  void
+){
+  static pthread_once_t o = PTHREAD_ONCE_INIT;
+  struct thr *t;
+
+  if (pthread_once(&o, thrKey))
+    return (0);
+  if (!(t = pthread_getspecific(Key))) {
+    if (!(t = calloc(1, sizeof (*t))))
+      return (0);
+    t->u = 1;
+    if (pthread_setspecific(Key, t)) {
+      free(t);
+      return (0);
+    }
+  }
+  return (t);
+}
+
+/* push a block on its allocating thread's return list */
+static void
+put(
+  struct blk *b
+){
+  struct thr *t;
+  struct blk *r;
+
+  t = b->h.o;
+  r = __atomic_load_n(&t->r, __ATOMIC_RELAXED);
+  do {
+    if (r == DEAD) {
+      free(b);
+      rls(t, 1);
+      return;
+    }
+    b->n = r;
+  } while (!__atomic_compare_exchange_n(&t->r, &r, b, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/* cache a block on its allocating thread's free list */
+static void
+cch(
+  struct thr *t
+ ,struct blk *b
+){
+  unsigned long c;
+
+  c = b->h.c;
+  if (t->n[c] >= ((1UL << SLBBYT) >> (c + SLBMIN)) + 1) {
+    free(b);
+    rls(t, 1);
+    return;
+  }
+  b->n = t->l[c];
+  t->l[c] = b;
+  ++t->n[c];
+}
+
+static void *
+alc(
+  unsigned long s
+){
+  struct thr *t;
+  struct blk *b;
+  struct blk *n;
+  struct hdr *h;
+  unsigned int c;
+
+  if (s > 1UL << SLBMAX
+   || !(t = thr())) {
+    if (s > ~0UL - sizeof (*h)
+     || !(h = malloc(sizeof (*h) + s)))
+      return (0);
+    h->o = 0;
+    h->c = s;
+    return (h + 1);
+  }
+  for (c = 0; 1UL << (c + SLBMIN) < s; ++c);
+  if (!(b = t->l[c])
+   && (b = __atomic_exchange_n(&t->r, 0, __ATOMIC_ACQUIRE))) {
+    for (; b; b = n) {
+      n = b->n;
+      cch(t, b);
+    }
+    b = t->l[c];
+  }
+  if (b) {
+    t->l[c] = b->n;
+    --t->n[c];
+    return (&b->h + 1);
+  }
+  if (!(h = malloc(sizeof (*h) + (1UL << (c + SLBMIN)))))
+    return (0);
+  __atomic_add_fetch(&t->u, 1, __ATOMIC_RELAXED);
+  h->o = t;
+  h->c = c;
+  return (h + 1);
+}
+
+void
+chanBlbSlbFree(
+  void *p
+){
+  struct hdr *h;
+
+  if (!p)
+    return;
+  h = (struct hdr *)p - 1;
+  if (!h->o)
+    free(h);
+  else if (h->o == pthread_getspecific(Key))
+    cch(h->o, (struct blk *)h);
+  else
+    put((struct blk *)h);
+}
+
+void *
+chanBlbSlbRealloc(
+  void *p
+ ,unsigned long s
+){
+  struct hdr *h;
+  void *n;
+  unsigned long o;
+  unsigned int c;
+
+  if (!p)
+    return (alc(s));
+  h = (struct hdr *)p - 1;
+  if (h->o) {
+    o = 1UL << (h->c + SLBMIN);
+    if (s <= o) {
+      for (c = 0; 1UL << (c + SLBMIN) < s; ++c);
+      if (c == h->c)
+        return (p);
+    }
+  } else {
+    o = h->c;
+    if (s > 1UL << SLBMAX) {
+      if (s > ~0UL - sizeof (*h)
+       || !(h = realloc(h, sizeof (*h) + s)))
+        return (0);
+      h->c = s;
+      return (h + 1);
+    }
+  }
+  if (!(n = alc(s)))
+    return (0);
+  memcpy(n, p, s < o ? s : o);
+  chanBlbSlbFree(p);
+  return (n);
+}
@@ -0,0 +1,47 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANBLBSLB_H__
+#define __CHANBLBSLB_H__
+
+/* Channel Blob slab allocator
+ *
+ * A realloc() and free() pair (for chanInit, chanBlb, chanBlbRef, etc.)
+ * tuned for blobs allocated by one thread and freed by another.
+ *
+ * Allocations are rounded up to a power of two size class (up to 128KiB, larger pass through).
+ * Each thread caches free blocks by size class, a block freed by another thread
+ * is pushed (without locking) on its allocating thread's return list and reused from there.
+ * Shrinking to a smaller size class moves the octets to a smaller block,
+ * so an ingress buffer is recycled instead of trimmed.
+ */
+
+void *
+chanBlbSlbRealloc(
+  void *pointer
+ ,unsigned long size
+);
+
+void
+chanBlbSlbFree(
+  void *pointer
+);
+
+#endif /* __CHANBLBSLB_H__ */
@@ -0,0 +1,486 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "chan.h"
+#include "chanBlb.h"
+#include "chanStrTmr.h"
+#include "chanBlbStrLOG.h"
+
+/* a record is a header (length + 1, 0 ends a segment; CRC-32 of length and octets) and length octets */
+#define HDR (2 * sizeof (unsigned int))
+
+static unsigned int Crc[256];
+static pthread_once_t CrcO = PTHREAD_ONCE_INIT;
+
+static void
+crcInit(
+  void
+){
+  unsigned int i;
+  unsigned int j;
+  unsigned int k;
+
+  for (i = 0; i < 256; ++i) {
+    for (k = i, j = 0; j < 8; ++j)
+      k = k & 1 ? (k >> 1) ^ 0xedb88320 : k >> 1;
+    Crc[i] = k;
+  }
+}
+
+static unsigned int
+crc(
+  unsigned int k
+ ,const unsigned char *b
+ ,unsigned long l
+){
+  k = ~k;
+  while (l--)
+    k = Crc[(k ^ *b++) & 0xff] ^ (k >> 8);
+  return (~k);
+}
+
+/* checkpoint, written alternately to one of two slots */
+struct chanBlbStrLOGk {
+  unsigned long long hs; /* head segment */
+  unsigned long long ho; /* head offset */
+  unsigned long long ts; /* tail segment */
+  unsigned long long to; /* tail offset */
+  unsigned long long y;  /* items */
+  unsigned long long g;  /* generation */
+  unsigned int c;        /* CRC-32 of the above */
+  unsigned int p;        /* pad */
+};
+
+struct chanBlbStrLOGs {
+  struct chanBlbStrLOGs *n; /* next segment */
+  unsigned char *b;         /* mapping */
+  unsigned long long q;     /* sequence */
+  unsigned long s;          /* size */
+  unsigned long w;          /* write offset */
+  unsigned long y;          /* synced offset */
+};
+
+struct chanBlbStrLOGc {
+  void *(*a)(void *, unsigned long); /* realloc routine */
+  void (*f)(void *);          /* free routine */
+  void (*d)(void *);          /* blob delete routine */
+  void *(*n)(unsigned long);  /* blob new routine */
+  int (*w)(void *, chanSs_t); /* wake routine */
+  void *x;                    /* wake closure */
+  void *m;                    /* timer */
+  char *p;                    /* path */
+  struct chanBlbStrLOGs *h;   /* head segment */
+  struct chanBlbStrLOGs *t;   /* tail segment */
+  struct chanBlbStrLOGs *e;   /* spare segment */
+  unsigned long long u;       /* first segment not yet removed */
+  unsigned long long g;       /* checkpoint generation */
+  unsigned long long y;       /* items */
+  unsigned long r;            /* head offset */
+  unsigned long z;            /* segment size */
+  unsigned long s;            /* store max */
+  unsigned long i;            /* sync interval, ns */
+  unsigned int k;             /* sync items */
+  unsigned int o;             /* items since sync */
+  unsigned int l;             /* directory length */
+  int dfd;                    /* directory */
+  int kfd;                    /* checkpoint file */
+  int nd;                     /* directory not synced */
+  int ar;                     /* timer armed */
+};
+
+#define C ((struct chanBlbStrLOGc *)c)
+
+static char *
+path(
+  void *c
+ ,unsigned long long q
+){
+  snprintf(C->p + C->l, 22, "/%016llx.log", q);
+  return (C->p);
+}
+
+/* map a segment, creating it when size is not zero, else sizing it from the file */
+static struct chanBlbStrLOGs *
+seg(
+  void *c
+ ,unsigned long long q
+ ,unsigned long s
+){
+  struct chanBlbStrLOGs *g;
+  struct stat t;
+  int f;
+  int o;
+
+  if (!(g = C->a(0, sizeof (*g))))
+    return (0);
+  o = s != 0;
+  if ((f = open(path(c, q), o ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0666)) < 0) {
+    C->f(g);
+    return (0);
+  }
+  /* reserve the octets so a full file system fails here instead of faulting on a store */
+  if (o) {
+    if (posix_fallocate(f, 0, s))
+      goto err;
+    C->nd = 1;
+  } else if (fstat(f, &t) || !(s = t.st_size))
+    goto err;
+  if ((g->b = mmap(0, s, PROT_READ | PROT_WRITE, MAP_SHARED, f, 0)) == MAP_FAILED)
+    goto err;
+  close(f);
+  madvise(g->b, s, MADV_SEQUENTIAL);
+  g->n = 0;
+  g->q = q;
+  g->s = s;
+  g->w = g->y = 0;
+  return (g);
+err:
+  close(f);
+  if (o)
+    unlink(C->p);
+  C->f(g);
+  return (0);
+}
+
+static void
+drop(
+  void *c
+ ,struct chanBlbStrLOGs *g
+){
+  munmap(g->b, g->s);
+  C->f(g);
+}
+
+/* length of a valid record at an offset, else -1 (0 is a clean end) */
+static long
+valid(
+  struct chanBlbStrLOGs *g
+ ,unsigned long o
+){
+  unsigned int n;
+  unsigned int k;
+
+  if (g->s - o < HDR)
+    return (0);
+  memcpy(&n, g->b + o, sizeof (n));
+  if (!n)
+    return (0);
+  memcpy(&k, g->b + o + sizeof (n), sizeof (k));
+  if (n - 1 > g->s - o - HDR
+   || crc(crc(0, g->b + o, sizeof (n)), g->b + o + HDR, n - 1) != k)
+    return (-1);
+  return (HDR + n - 1);
+}
+
+/* make records durable, then checkpoint, then remove read segments, return 0 on failure */
+static int
+durable(
+  void *c
+){
+  struct chanBlbStrLOGk k;
+  struct chanBlbStrLOGs *g;
+  unsigned long p;
+
+  p = sysconf(_SC_PAGESIZE);
+  for (g = C->h; g; g = g->n)
+    if (g->y < g->w) {
+      if (msync(g->b + (g->y & ~(p - 1)), g->w - (g->y & ~(p - 1)), MS_SYNC))
+        return (0);
+      g->y = g->w;
+    }
+  if (C->nd) {
+    if (fsync(C->dfd))
+      return (0);
+    C->nd = 0;
+  }
+  memset(&k, 0, sizeof (k));
+  k.hs = C->h->q;
+  k.ho = C->r;
+  k.ts = C->t->q;
+  k.to = C->t->w;
+  k.y = C->y;
+  k.g = ++C->g;
+  k.c = crc(0, (unsigned char *)&k, (unsigned char *)&k.c - (unsigned char *)&k);
+  if (pwrite(C->kfd, &k, sizeof (k), (k.g & 1) * sizeof (k)) != sizeof (k)
+   || fdatasync(C->kfd))
+    return (0);
+  for (; C->u < C->h->q; ++C->u)
+    unlink(path(c, C->u));
+  C->o = 0;
+  return (1);
+}
+
+static void
+fire(
+  void *c
+){
+  C->w(C->x, chanSsWake);
+}
+
+static void
+chanBlbStrLOGd(
+  void *c
+ ,chanSs_t s
+){
+  struct chanBlbStrLOGs *g;
+
+  if (!c)
+    return;
+  chanStrTmrDel(C->m);
+  if (C->h && C->o)
+    durable(c);
+  for (; C->h; C->h = g) {
+    g = C->h->n;
+    drop(c, C->h);
+  }
+  if (C->e)
+    drop(c, C->e);
+  if (C->kfd >= 0)
+    close(C->kfd);
+  if (C->dfd >= 0)
+    close(C->dfd);
+  C->f(C->p);
+  C->f(c);
+  (void)s; /* not needed */
+}
+
+#define V ((chanBlb_t **)v)
+
+static chanSs_t
+chanBlbStrLOGi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  struct chanBlbStrLOGs *g;
+  struct timespec a;
+  unsigned long z;
+  unsigned int n;
+  unsigned int k;
+  chanSs_t s;
+
+  if (!c)
+    return (0);
+  if (o == chanSoPut) {
+    z = HDR + (*V)->l;
+    if (C->t->s - C->t->w < z) {
+      if (C->e->s < z) {
+        drop(c, C->e);
+        if (!(C->e = seg(c, C->t->q + 1, z)))
+          return (0);
+      }
+      C->t->n = C->e;
+      C->t = C->e;
+      C->e = 0;
+    }
+    g = C->t;
+    n = (*V)->l + 1;
+    memcpy(g->b + g->w, &n, sizeof (n));
+    k = crc(crc(0, (unsigned char *)&n, sizeof (n)), (*V)->b, (*V)->l);
+    memcpy(g->b + g->w + sizeof (n), &k, sizeof (k));
+    memcpy(g->b + g->w + HDR, (*V)->b, (*V)->l);
+    g->w += z;
+    C->d(*v);
+    ++C->y;
+    ++C->o;
+  } else if (o == chanSoGet) {
+    while (C->h->s - C->r < HDR
+     || (memcpy(&n, C->h->b + C->r, sizeof (n)), !n)) {
+      g = C->h;
+      C->h = g->n;
+      C->r = 0;
+      drop(c, g);
+    }
+    if (!(*v = C->n(chanBlb_tSize(n - 1))))
+      return (0);
+    (*V)->l = n - 1;
+    memcpy((*V)->b, C->h->b + C->r + HDR, n - 1);
+    C->r += HDR + n - 1;
+    --C->y;
+    ++C->o;
+  } else
+    C->ar = 0;
+  if (C->o) {
+    if ((C->k && C->o >= C->k) || o == chanSoNop) {
+      if (!durable(c))
+        return (0);
+    } else if (C->i && !C->ar) {
+      clock_gettime(CLOCK_MONOTONIC, &a);
+      a.tv_sec += C->i / 1000000000;
+      if ((a.tv_nsec += C->i % 1000000000) >= 1000000000) {
+        a.tv_nsec -= 1000000000;
+        ++a.tv_sec;
+      }
+      chanStrTmrSet(C->m, &a);
+      C->ar = 1;
+    }
+  }
+  s = 0;
+  if (C->y < C->s
+   && (C->e || (C->e = seg(c, C->t->q + 1, C->z))))
+    s |= chanSsCanPut;
+  if (C->y)
+    s |= chanSsCanGet;
+  return (s);
+  (void)w; /* not concerned with latency */
+}
+
+#undef V
+
+/* recover the log, return 0 on failure */
+static int
+recover(
+  void *c
+){
+  struct chanBlbStrLOGk k[2];
+  struct chanBlbStrLOGk *b;
+  struct chanBlbStrLOGs *g;
+  unsigned long long q;
+  long n;
+  int i;
+
+  b = 0;
+  if (pread(C->kfd, k, sizeof (k), 0) == sizeof (k))
+    for (i = 0; i < 2; ++i)
+      if (k[i].c == crc(0, (unsigned char *)(k + i), (unsigned char *)&k[i].c - (unsigned char *)(k + i))
+       && (!b || k[i].g > b->g))
+        b = k + i;
+  if (!b) {
+    if (!(C->h = C->t = seg(c, 0, C->z)))
+      return (0);
+    C->u = 0;
+    C->o = 1;
+    return (durable(c));
+  }
+  C->g = b->g;
+  C->y = b->y;
+  C->r = b->ho;
+  C->u = b->hs;
+  for (q = b->hs; q <= b->ts; ++q) {
+    if (!(g = seg(c, q, 0)))
+      return (0);
+    if (C->t)
+      C->t->n = g;
+    else
+      C->h = g;
+    C->t = g;
+  }
+  /* keep valid records past the checkpoint tail, following clean ends into later segments */
+  for (g = C->t, g->w = b->to; ; g = g->n) {
+    while ((n = valid(g, g->w)) > 0) {
+      g->w += n;
+      ++C->y;
+    }
+    g->y = g->w;
+    C->t = g;
+    if (n < 0 || !(g->n = seg(c, g->q + 1, 0)))
+      break;
+  }
+  if (n < 0) {
+    memset(g->b + g->w, 0, g->s - g->w);
+    for (q = g->q + 1; !unlink(path(c, q)); ++q);
+  }
+  for (q = C->u; q-- && !unlink(path(c, q)););
+  C->o = 1;
+  return (durable(c));
+}
+
+#undef C
+
+chanSs_t
+chanBlbStrLOGa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanBlbStrLOGc *c;
+  void *(*n)(unsigned long);
+  const char *p;
+  unsigned long z;
+  unsigned long s;
+  unsigned int k;
+  unsigned long t;
+  unsigned int j;
+  chanSs_t r;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  n = va_arg(l, void *(*)(unsigned long)); /* blob new routine */
+  p = va_arg(l, const char *);             /* log directory */
+  z = va_arg(l, unsigned long);            /* segment size */
+  s = va_arg(l, unsigned long);            /* size to allow */
+  k = va_arg(l, unsigned int);             /* sync items */
+  t = va_arg(l, unsigned long);            /* sync interval */
+  if (!a || !f || !u || !w || !n || !p || z < HDR || !s)
+    return (0);
+  pthread_once(&CrcO, crcInit);
+  if (!(c = a(0, sizeof (*c))))
+    return (0);
+  memset(c, 0, sizeof (*c));
+  c->dfd = c->kfd = -1;
+  c->a = a;
+  c->f = f;
+  c->d = u;
+  c->n = n;
+  c->w = w;
+  c->x = x;
+  c->z = z;
+  c->s = s;
+  c->k = k;
+  c->i = t;
+  j = strlen(p);
+  c->l = j;
+  if (!(c->p = a(0, j + 22))
+   || !(c->m = chanStrTmrNew(a, f, fire, c)))
+    goto err;
+  memcpy(c->p, p, j);
+  memcpy(c->p + j, "/checkpoint", sizeof ("/checkpoint"));
+  if ((c->dfd = open(p, O_RDONLY | O_DIRECTORY)) < 0
+   || (c->kfd = open(c->p, O_RDWR | O_CREAT, 0666)) < 0
+   || !recover(c))
+    goto err;
+  r = chanBlbStrLOGi(c, chanSoNop, 0, 0);
+  if (!r)
+    goto err;
+  *d = chanBlbStrLOGd;
+  *i = chanBlbStrLOGi;
+  *v = c;
+  return (r);
+err:
+  c->o = 0;
+  chanBlbStrLOGd(c, 0);
+  return (0);
+}
@@ -0,0 +1,55 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANBLBSTRLOG_H__
+#define __CHANBLBSTRLOG_H__
+
+/* a maximum sized persistent FIFO Store of chanBlb_t items in an append-only log
+ *  the log is a directory of preallocated, memory mapped segment files of length and CRC prefixed records
+ *  a checkpoint file holds the head and tail, written only after the records it covers are synced
+ *  a sync (msync, then checkpoint) is done after every syncItems Puts and Gets (0 for none)
+ *  and syncNs after a Put or Get not yet synced (0 for none), and on deallocation
+ *  on allocation, the log is recovered from the checkpoint, records found valid past its tail are kept
+ *  Gets since the last sync are got again after a crash (at-least-once)
+ *  a record larger than segment gets a segment of its own, segment files are removed when read and synced
+ *  if a segment can't be created, Put waits for a Get
+ *  if a Get can't allocate a blob or a sync fails, the Channel is shutdown
+ *  a blob deallocation function is required (put blobs are deallocated)
+ */
+chanSs_t
+chanBlbStrLOGa(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/*  void *(*allocBlb)(unsigned long) */
+/*  const char *directory */
+/*  unsigned long segment (octets in a segment file) */
+/*  unsigned long size (items to allow) */
+/*  unsigned int syncItems */
+/*  unsigned long syncNs */
+);
+
+#endif /* __CHANBLBSTRLOG_H__ */
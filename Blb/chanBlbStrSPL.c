@@ -0,0 +1,280 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "chan.h"
+#include "chanBlb.h"
+#include "chanBlbStrSPL.h"
+
+struct chanBlbStrSPLs {
+  struct chanBlbStrSPLs *n; /* next segment */
+  unsigned char *b;         /* mapping */
+  unsigned long s;          /* size */
+  unsigned long r;          /* read offset */
+  unsigned long w;          /* write offset */
+};
+
+struct chanBlbStrSPLc {
+  void *(*a)(void *, unsigned long); /* realloc routine */
+  void (*f)(void *);          /* free routine */
+  void (*d)(void *);          /* blob delete routine */
+  void *(*n)(unsigned long);  /* blob new routine */
+  chanBlb_t **q;              /* head ring (first m) and tail ring (last m) */
+  char *p;                    /* segment file template */
+  struct chanBlbStrSPLs *h;   /* read segment */
+  struct chanBlbStrSPLs *t;   /* write segment */
+  unsigned long z;            /* segment size */
+  unsigned long x;            /* store max */
+  unsigned long y;            /* items */
+  unsigned long k;            /* items in segments */
+  unsigned int l;             /* template length */
+  unsigned int m;             /* ring size */
+  unsigned int hi;            /* head ring offset */
+  unsigned int hn;            /* head ring items */
+  unsigned int ti;            /* tail ring offset */
+  unsigned int tn;            /* tail ring items */
+};
+
+#define C ((struct chanBlbStrSPLc *)c)
+
+static void
+drop(
+  void *c
+ ,struct chanBlbStrSPLs *g
+){
+  munmap(g->b, g->s);
+  C->f(g);
+}
+
+/* append the oldest tail item to the write segment, return 0 on failure */
+static int
+spill(
+  void *c
+){
+  struct chanBlbStrSPLs *g;
+  chanBlb_t *b;
+  unsigned long z;
+  int f;
+
+  b = C->q[C->m + C->ti];
+  z = sizeof (b->l) + b->l;
+  if (!(g = C->t) || g->s - g->w < z) {
+    if (!(g = C->a(0, sizeof (*g))))
+      return (0);
+    if ((g->s = C->z) < z)
+      g->s = z;
+    memcpy(C->p + C->l - 6, "XXXXXX", 6);
+    if ((f = mkstemp(C->p)) < 0) {
+      C->f(g);
+      return (0);
+    }
+    unlink(C->p);
+    /* reserve the octets so a full file system fails here instead of faulting on a store */
+    if (posix_fallocate(f, 0, g->s)
+     || (g->b = mmap(0, g->s, PROT_READ | PROT_WRITE, MAP_SHARED, f, 0)) == MAP_FAILED) {
+      close(f);
+      C->f(g);
+      return (0);
+    }
+    close(f);
+    madvise(g->b, g->s, MADV_SEQUENTIAL);
+    g->n = 0;
+    g->r = g->w = 0;
+    if (C->t)
+      C->t->n = g;
+    else
+      C->h = g;
+    C->t = g;
+  }
+  memcpy(g->b + g->w, &b->l, sizeof (b->l));
+  memcpy(g->b + g->w + sizeof (b->l), b->b, b->l);
+  g->w += z;
+  C->d(b);
+  C->ti = (C->ti + 1) % C->m;
+  --C->tn;
+  ++C->k;
+  return (1);
+}
+
+/* return the oldest segment item, 0 on failure */
+static chanBlb_t *
+fill(
+  void *c
+){
+  struct chanBlbStrSPLs *g;
+  chanBlb_t *b;
+  unsigned int l;
+
+  g = C->h;
+  memcpy(&l, g->b + g->r, sizeof (l));
+  if (!(b = C->n(chanBlb_tSize(l))))
+    return (0);
+  b->l = l;
+  memcpy(b->b, g->b + g->r + sizeof (l), l);
+  g->r += sizeof (l) + l;
+  --C->k;
+  if (g->r == g->w) {
+    if (g->n) {
+      C->h = g->n;
+      drop(c, g);
+    } else
+      g->r = g->w = 0;
+  }
+  return (b);
+}
+
+static void
+chanBlbStrSPLd(
+  void *c
+ ,chanSs_t s
+){
+  struct chanBlbStrSPLs *g;
+
+  if (!c)
+    return;
+  for (; C->hn; --C->hn, C->hi = (C->hi + 1) % C->m)
+    C->d(C->q[C->hi]);
+  for (; C->tn; --C->tn, C->ti = (C->ti + 1) % C->m)
+    C->d(C->q[C->m + C->ti]);
+  for (; C->h; C->h = g) {
+    g = C->h->n;
+    drop(c, C->h);
+  }
+  C->f(C->p);
+  C->f(C->q);
+  C->f(c);
+  (void)s; /* not needed */
+}
+
+#define V ((chanBlb_t **)v)
+
+static chanSs_t
+chanBlbStrSPLi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  chanBlb_t *b;
+  chanSs_t s;
+
+  if (!c)
+    return (0);
+  if (o == chanSoPut) {
+    if (!C->k && !C->tn && C->hn < C->m)
+      C->q[(C->hi + C->hn++) % C->m] = *V;
+    else
+      C->q[C->m + (C->ti + C->tn++) % C->m] = *V;
+    ++C->y;
+  } else {
+    *V = C->q[C->hi];
+    C->hi = (C->hi + 1) % C->m;
+    --C->hn;
+    --C->y;
+    while (C->hn < C->m) {
+      if (C->k) {
+        if (!(b = fill(c)))
+          break;
+      } else if (C->tn) {
+        b = C->q[C->m + C->ti];
+        C->ti = (C->ti + 1) % C->m;
+        --C->tn;
+      } else
+        break;
+      C->q[(C->hi + C->hn++) % C->m] = b;
+    }
+  }
+  s = 0;
+  if (C->y < C->x
+   && ((!C->k && !C->tn && C->hn < C->m) || C->tn < C->m || spill(c))) /* as the Put will */
+    s |= chanSsCanPut;
+  if (C->hn)
+    s |= chanSsCanGet;
+  else if (C->y)
+    return (0);
+  return (s);
+  (void)w; /* not concerned with latency */
+}
+
+#undef V
+
+#undef C
+
+chanSs_t
+chanBlbStrSPLa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanBlbStrSPLc *c;
+  void *(*n)(unsigned long);
+  const char *p;
+  unsigned int m;
+  unsigned long z;
+  unsigned long s;
+  unsigned int k;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  n = va_arg(l, void *(*)(unsigned long)); /* blob new routine */
+  p = va_arg(l, const char *);             /* segment file directory */
+  m = va_arg(l, unsigned int);             /* items at head and at tail */
+  z = va_arg(l, unsigned long);            /* segment size */
+  s = va_arg(l, unsigned long);            /* size to allow */
+  if (!a || !f || !u || !n || !p || !m || !z || !s)
+    return (0);
+  if (!(c = a(0, sizeof (*c))))
+    return (0);
+  memset(c, 0, sizeof (*c));
+  k = strlen(p);
+  if (!(c->q = a(0, 2 * m * sizeof (*c->q)))
+   || !(c->p = a(0, k + sizeof ("/chanBlbStrSPLXXXXXX")))) {
+    f(c->q);
+    f(c);
+    return (0);
+  }
+  memcpy(c->p, p, k);
+  memcpy(c->p + k, "/chanBlbStrSPLXXXXXX", sizeof ("/chanBlbStrSPLXXXXXX"));
+  c->l = k + sizeof ("/chanBlbStrSPLXXXXXX") - 1;
+  c->a = a;
+  c->f = f;
+  c->d = u;
+  c->n = n;
+  c->m = m;
+  c->z = z;
+  c->x = s;
+  *d = chanBlbStrSPLd;
+  *i = chanBlbStrSPLi;
+  *v = c;
+  return (chanSsCanPut);
+  (void)w; /* wake callback */
+  (void)x; /* wake callback closure */
+}
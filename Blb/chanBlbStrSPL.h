@@ -0,0 +1,52 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANBLBSTRSPL_H__
+#define __CHANBLBSTRSPL_H__
+
+/* a maximum sized FIFO Store of chanBlb_t items that spills to disk
+ *  up to memory items are held at the head (next to Get) and at the tail (last Put)
+ *  when the tail is full, its oldest item is appended to a memory mapped segment file and deallocated
+ *  as the head drains, it is refilled sequentially from the segment files, then from the tail
+ *  segment files are created (unlinked) in directory, a segment is reused once read, else removed
+ *  a record larger than segment gets a segment of its own
+ *  if a segment can't be created, Put waits for a Get
+ *  if a Get can't allocate a blob, the Channel is shutdown
+ *  a blob deallocation function is required (spilled blobs are deallocated)
+ */
+chanSs_t
+chanBlbStrSPLa(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/*  void *(*allocBlb)(unsigned long) */
+/*  const char *directory */
+/*  unsigned int memory (items at head and at tail) */
+/*  unsigned long segment (octets in a segment file) */
+/*  unsigned long size (items to allow) */
+);
+
+#endif /* __CHANBLBSTRSPL_H__ */
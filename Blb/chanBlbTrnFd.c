@@ -20,6 +20,8 @@
 
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
 #include "chanBlbTrnFd.h"
 
 struct ctx {
@@ -67,6 +69,17 @@ chanBlbTrnFdInput(
   return (i);
 }
 
+unsigned int
+chanBlbTrnFdInputAvail(
+  void *v
+){
+  int i;
+
+  if (ioctl(V->i, FIONREAD, &i) < 0 || i < 0)
+    i = 0;
+  return (i);
+}
+
 void
 chanBlbTrnFdInputClose(
   void *v
@@ -97,6 +110,19 @@ chanBlbTrnFdOutput(
   return (i);
 }
 
+unsigned int
+chanBlbTrnFdOutputv(
+  void *v
+ ,const struct iovec *d
+ ,int n
+){
+  int i;
+
+  if ((i = writev(V->o, d, n)) < 0)
+    i = 0;
+  return (i);
+}
+
 void
 chanBlbTrnFdOutputClose(
   void *v
@@ -21,6 +21,8 @@
 #ifndef __CHANBLBTRNFD_H__
 #define __CHANBLBTRNFD_H__
 
+struct iovec;
+
 void *
 chanBlbTrnFdCtx(
   void *(*realloc)(void *, unsigned long)
@@ -40,6 +42,11 @@ chanBlbTrnFdInput(
 ,unsigned int length
 );
 
+unsigned int
+chanBlbTrnFdInputAvail(
+  void *inputCtx
+);
+
 void
 chanBlbTrnFdInputClose(
   void *inputCtx
@@ -58,6 +65,13 @@ chanBlbTrnFdOutput(
  ,unsigned int length
 );
 
+unsigned int
+chanBlbTrnFdOutputv(
+  void *outputCtx
+ ,const struct iovec *iov
+ ,int iovcnt
+);
+
 void
 chanBlbTrnFdOutputClose(
   void *outputCtx
@@ -22,6 +22,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <poll.h>
 #include "chanBlbTrnFdDatagram.h"
 
@@ -253,6 +254,62 @@ chanBlbTrnFdDatagramOutput(
   return (l);
 }
 
+unsigned int
+chanBlbTrnFdDatagramOutputv(
+  void *v
+ ,const struct iovec *d
+ ,int n
+){
+  struct iovec x[8];
+  struct msghdr h;
+  const unsigned char *b;
+  unsigned int l;
+  unsigned int i;
+
+  if (n < 1
+   || n > (int)(sizeof (x) / sizeof (x[0]))
+   || d[0].iov_len < 1)
+    return (0);
+  b = d[0].iov_base;
+  if (b[0] < sizeof (sa_family_t)
+   || b[0] > sizeof (struct sockaddr_storage)
+   || d[0].iov_len < 1U + b[0])
+    return (0);
+  x[0].iov_base = (unsigned char *)b + 1 + b[0];
+  x[0].iov_len = d[0].iov_len - 1 - b[0];
+  for (l = x[0].iov_len, i = 1; i < (unsigned int)n; ++i) {
+    x[i] = d[i];
+    l += d[i].iov_len;
+  }
+  if (!l)
+    return (0);
+  memset(&h, 0, sizeof (h));
+  h.msg_name = (void *)&b[1];
+  h.msg_namelen = b[0];
+  h.msg_iov = x;
+  h.msg_iovlen = n;
+  /* as Output, no-fd-for-family and unknown family are drop-and-continue */
+  switch (((struct sockaddr *)&b[1])->sa_family) {
+  case AF_INET:
+    for (i = 0; i < V->o4n; ++i) {
+      if (sendmsg(V->o4[i], &h, 0) < 0
+       && (errno == EBADF || errno == ENOTSOCK))
+        return (0);
+    }
+    break;
+  case AF_INET6:
+    for (i = 0; i < V->o6n; ++i) {
+      if (sendmsg(V->o6[i], &h, 0) < 0
+       && (errno == EBADF || errno == ENOTSOCK))
+        return (0);
+    }
+    break;
+  default:
+    break;
+  }
+  return (1 + b[0] + l);
+}
+
 void
 chanBlbTrnFdDatagramOutputClose(
   void *v
@@ -21,6 +21,8 @@
 #ifndef __CHANBLBTRNFDDATAGRAM_H__
 #define __CHANBLBTRNFDDATAGRAM_H__
 
+struct iovec;
+
 void *
 chanBlbTrnFdDatagramCtx(
   void *(*realloc)(void *, unsigned long)
@@ -76,6 +78,14 @@ chanBlbTrnFdDatagramOutput(
  ,unsigned int length
 );
 
+/* as Output, one datagram gathered from (at most 8) iovecs, the first holding at least the address */
+unsigned int
+chanBlbTrnFdDatagramOutputv(
+  void *outputCtx
+ ,const struct iovec *iov
+ ,int iovcnt
+);
+
 void
 chanBlbTrnFdDatagramOutputClose(
   void *outputCtx
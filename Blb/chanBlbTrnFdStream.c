@@ -19,6 +19,8 @@
  */
 
 #include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <sys/socket.h>
 #include "chanBlbTrnFdStream.h"
 
@@ -52,6 +54,17 @@ chanBlbTrnFdStreamInput(
   return (i);
 }
 
+unsigned int
+chanBlbTrnFdStreamInputAvail(
+  void *v
+){
+  int i;
+
+  if (ioctl((int)(long)v, FIONREAD, &i) < 0 || i < 0)
+    i = 0;
+  return (i);
+}
+
 void
 chanBlbTrnFdStreamInputClose(
   void *v
@@ -79,6 +92,19 @@ chanBlbTrnFdStreamOutput(
   return (i);
 }
 
+unsigned int
+chanBlbTrnFdStreamOutputv(
+  void *v
+ ,const struct iovec *d
+ ,int n
+){
+  int i;
+
+  if ((i = writev((int)(long)v, d, n)) < 0)
+    i = 0;
+  return (i);
+}
+
 void
 chanBlbTrnFdStreamOutputClose(
   void *v
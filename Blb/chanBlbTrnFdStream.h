@@ -21,6 +21,8 @@
 #ifndef __CHANBLBTRNFDSTREAM_H__
 #define __CHANBLBTRNFDSTREAM_H__
 
+struct iovec;
+
 void *
 chanBlbTrnFdStreamCtx(
   void *(*realloc)(void *, unsigned long)
@@ -40,6 +42,11 @@ chanBlbTrnFdStreamInput(
  ,unsigned int length
 );
 
+unsigned int
+chanBlbTrnFdStreamInputAvail(
+  void *InputCtx
+);
+
 void
 chanBlbTrnFdStreamInputClose(
   void *InputCtx
@@ -57,6 +64,13 @@ chanBlbTrnFdStreamOutput(
  ,unsigned int length
 );
 
+unsigned int
+chanBlbTrnFdStreamOutputv(
+  void *outputCtx
+ ,const struct iovec *iov
+ ,int iovcnt
+);
+
 void
 chanBlbTrnFdStreamOutputClose(
   void *outputCtx
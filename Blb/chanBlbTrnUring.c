@@ -0,0 +1,716 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <linux/io_uring.h>
+#include "chanBlbTrnUring.h"
+
+struct ctx;
+
+/* a request, done when its completion is reaped */
+struct req {
+  struct chanBlbTrnUring *u;
+  struct ctx *x;     /* multishot receive of a context, else 0 */
+  pthread_cond_t c;
+  int r;             /* result */
+  int d;             /* done */
+};
+
+/* a multishot receive completion */
+struct cqe {
+  int r;
+  unsigned int f;
+};
+
+struct chanBlbTrnUring {
+  void *(*ma)(void *, unsigned long);
+  void (*mf)(void *);
+  struct io_uring_sqe *se;
+  struct io_uring_cqe *ce;
+  unsigned int *sh;  /* submission head */
+  unsigned int *st;  /* submission tail */
+  unsigned int *sm;  /* submission mask */
+  unsigned int *sa;  /* submission array */
+  unsigned int *ch;  /* completion head */
+  unsigned int *ct;  /* completion tail */
+  unsigned int *cm;  /* completion mask */
+  void *rs;          /* submission (and completion) ring */
+  void *rc;          /* completion ring */
+  unsigned long rl;
+  unsigned long cl;
+  unsigned long el;
+  struct io_uring_buf_ring *br; /* provided buffer ring */
+  unsigned char *bb; /* provided buffers */
+  int *fs;           /* fixed file slots */
+  unsigned int fn;   /* fixed file slot count */
+  unsigned int bn;   /* provided buffer count */
+  unsigned int bz;   /* provided buffer size */
+  unsigned int sn;   /* submission entries */
+  unsigned int p;    /* submissions pending */
+  int s;             /* reaper signaled */
+  int ev;            /* eventfd, to signal the reaper */
+  int fd;
+  pthread_mutex_t m;
+  pthread_t t;
+};
+
+struct ctx {
+  struct chanBlbTrnUring *u;
+  struct cqe *q;     /* multishot receive completions */
+  struct req ri;
+  struct req ro;
+  unsigned int qh;
+  unsigned int qn;
+  int i;
+  int o;
+  int si;            /* input fixed file slot */
+  int so;            /* output fixed file slot */
+  int dg;            /* datagram */
+  int am;            /* multishot receive armed */
+};
+
+static int
+enter(
+  int f
+ ,unsigned int n
+ ,unsigned int m
+ ,unsigned int g
+){
+  return (syscall(__NR_io_uring_enter, f, n, m, g, 0, 0));
+}
+
+static int
+reg(
+  int f
+ ,unsigned int o
+ ,void *a
+ ,unsigned int n
+){
+  return (syscall(__NR_io_uring_register, f, o, a, n));
+}
+
+/* submit, with u->m (the reaper enters submissions, so they aren't cancelled when a bridge thread exits) */
+static void
+put(
+  struct chanBlbTrnUring *u
+ ,const struct io_uring_sqe *e
+){
+  unsigned long long o;
+  unsigned int t;
+
+  o = 1;
+  while ((t = *u->st) - __atomic_load_n(u->sh, __ATOMIC_ACQUIRE) == u->sn) {
+    if (!u->s && write(u->ev, &o, sizeof (o)) > 0)
+      u->s = 1;
+    pthread_mutex_unlock(&u->m);
+    sched_yield();
+    pthread_mutex_lock(&u->m);
+  }
+  *(u->se + (t & *u->sm)) = *e;
+  *(u->sa + (t & *u->sm)) = t & *u->sm;
+  __atomic_store_n(u->st, t + 1, __ATOMIC_RELEASE);
+  ++u->p;
+  if (!u->s && write(u->ev, &o, sizeof (o)) > 0) /* submissions till the reaper enters go together */
+    u->s = 1;
+}
+
+/* return a provided buffer, with u->m */
+static void
+buf(
+  struct chanBlbTrnUring *u
+ ,unsigned int i
+){
+  struct io_uring_buf *b;
+  unsigned short t;
+
+  t = u->br->tail;
+  b = u->br->bufs + (t & (u->bn - 1));
+  b->addr = (unsigned long)(u->bb + (unsigned long)i * u->bz);
+  b->len = u->bz;
+  b->bid = i;
+  __atomic_store_n(&u->br->tail, t + 1, __ATOMIC_RELEASE);
+}
+
+static void *
+reaper(
+  void *v
+#define V ((struct chanBlbTrnUring *)v)
+){
+  struct io_uring_cqe *c;
+  struct req *q;
+  unsigned long long o;
+  unsigned int h;
+  unsigned int t;
+  unsigned int n;
+  int a;
+  int r;
+  int x;
+
+  a = 0;
+  for (x = 0; !x;) {
+    pthread_mutex_lock(&V->m);
+    if (!a && *V->st - __atomic_load_n(V->sh, __ATOMIC_ACQUIRE) < V->sn) { /* wake on eventfd */
+      struct io_uring_sqe e;
+
+      memset(&e, 0, sizeof (e));
+      e.opcode = IORING_OP_POLL_ADD;
+      e.fd = V->ev;
+      e.poll32_events = POLLIN;
+      e.user_data = 2;
+      t = *V->st;
+      *(V->se + (t & *V->sm)) = e;
+      *(V->sa + (t & *V->sm)) = t & *V->sm;
+      __atomic_store_n(V->st, t + 1, __ATOMIC_RELEASE);
+      ++V->p;
+      a = 1;
+    }
+    n = V->p;
+    V->p = 0;
+    V->s = 0;
+    pthread_mutex_unlock(&V->m);
+    if ((r = enter(V->fd, n, 1, IORING_ENTER_GETEVENTS)) < 0) {
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        break;
+      r = 0;
+    }
+    pthread_mutex_lock(&V->m);
+    if ((unsigned int)r < n)
+      V->p += n - r;
+    for (h = *V->ch, t = __atomic_load_n(V->ct, __ATOMIC_ACQUIRE); h != t; ++h) {
+      c = V->ce + (h & *V->cm);
+      if (!c->user_data) { /* chanBlbTrnUringDel */
+        x = 1;
+        continue;
+      }
+      if (c->user_data == 1) /* a cancel */
+        continue;
+      if (c->user_data == 2) { /* eventfd */
+        if (read(V->ev, &o, sizeof (o)) < 0) {} /* drained */
+        a = 0;
+        continue;
+      }
+      q = (struct req *)(unsigned long)c->user_data;
+      if (q->x) {
+        struct cqe *p;
+
+        p = q->x->q + (q->x->qh + q->x->qn++) % (V->bn + 1);
+        p->r = c->res;
+        p->f = c->flags;
+        if (!(c->flags & IORING_CQE_F_MORE))
+          q->x->am = 0;
+      } else {
+        q->r = c->res;
+        q->d = 1;
+      }
+      pthread_cond_signal(&q->c);
+    }
+    __atomic_store_n(V->ch, h, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&V->m);
+  }
+  return (0);
+#undef V
+}
+
+/* cancelled waiting, a request must complete before its context is closed */
+static void
+reqCan(
+  void *v
+#define V ((struct req *)v)
+){
+  struct io_uring_sqe e;
+
+  if (!V->d) {
+    memset(&e, 0, sizeof (e));
+    e.opcode = IORING_OP_ASYNC_CANCEL;
+    e.fd = -1;
+    e.addr = (unsigned long)v;
+    e.user_data = 1;
+    put(V->u, &e);
+    while (!V->d)
+      pthread_cond_wait(&V->c, &V->u->m);
+  }
+  pthread_mutex_unlock(&V->u->m);
+#undef V
+}
+
+/* submit and wait for a request, return its result */
+static int
+req(
+  struct req *q
+ ,struct io_uring_sqe *e
+){
+  int r;
+
+  e->user_data = (unsigned long)q;
+  pthread_mutex_lock(&q->u->m);
+  q->d = 0;
+  put(q->u, e);
+  pthread_cleanup_push(reqCan, q);
+  while (!q->d)
+    pthread_cond_wait(&q->c, &q->u->m);
+  pthread_cleanup_pop(0);
+  r = q->r;
+  pthread_mutex_unlock(&q->u->m);
+  return (r);
+}
+
+/* a fixed file slot for f, else -1 */
+static int
+slot(
+  struct chanBlbTrnUring *u
+ ,int f
+){
+  struct io_uring_files_update p;
+  unsigned int i;
+
+  if (f < 0)
+    return (-1);
+  pthread_mutex_lock(&u->m);
+  for (i = 0; i < u->fn && *(u->fs + i) >= 0; ++i);
+  if (i < u->fn)
+    *(u->fs + i) = f;
+  pthread_mutex_unlock(&u->m);
+  if (i == u->fn)
+    return (-1);
+  memset(&p, 0, sizeof (p));
+  p.offset = i;
+  p.fds = (unsigned long)&f;
+  if (reg(u->fd, IORING_REGISTER_FILES_UPDATE, &p, 1) != 1) {
+    pthread_mutex_lock(&u->m);
+    *(u->fs + i) = -1;
+    pthread_mutex_unlock(&u->m);
+    return (-1);
+  }
+  return (i);
+}
+
+static void
+unslot(
+  struct chanBlbTrnUring *u
+ ,int i
+){
+  struct io_uring_files_update p;
+  int f;
+
+  if (i < 0)
+    return;
+  f = -1;
+  memset(&p, 0, sizeof (p));
+  p.offset = i;
+  p.fds = (unsigned long)&f;
+  reg(u->fd, IORING_REGISTER_FILES_UPDATE, &p, 1);
+  pthread_mutex_lock(&u->m);
+  *(u->fs + i) = -1;
+  pthread_mutex_unlock(&u->m);
+}
+
+chanBlbTrnUring_t *
+chanBlbTrnUringNew(
+  void *(*ma)(void *, unsigned long)
+ ,void (*mf)(void *)
+ ,unsigned int n
+ ,unsigned int f
+ ,unsigned int b
+ ,unsigned int z
+ ,pthread_attr_t *a
+){
+  struct chanBlbTrnUring *u;
+  struct io_uring_params p;
+  unsigned int i;
+
+  if (!ma || !mf
+   || (b && (b & (b - 1) || b > 32768 || !z))
+   || !(u = ma(0, sizeof (*u))))
+    return (0);
+  u->ma = ma;
+  u->mf = mf;
+  memset(&p, 0, sizeof (p));
+  if ((u->fd = syscall(__NR_io_uring_setup, n ? n : 256, &p)) < 0) {
+    mf(u);
+    return (0);
+  }
+  u->sn = p.sq_entries;
+  u->rl = p.sq_off.array + p.sq_entries * sizeof (unsigned int);
+  u->cl = p.cq_off.cqes + p.cq_entries * sizeof (struct io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    if (u->cl > u->rl)
+      u->rl = u->cl;
+    u->cl = 0;
+  }
+  u->el = p.sq_entries * sizeof (struct io_uring_sqe);
+  u->rc = MAP_FAILED;
+  u->se = MAP_FAILED;
+  u->fs = 0;
+  u->br = MAP_FAILED;
+  u->bb = 0;
+  u->bn = 0;
+  u->ev = -1;
+  if ((u->rs = mmap(0, u->rl, PROT_READ | PROT_WRITE, MAP_SHARED, u->fd, IORING_OFF_SQ_RING)) == MAP_FAILED
+   || (u->rc = u->cl ? mmap(0, u->cl, PROT_READ | PROT_WRITE, MAP_SHARED, u->fd, IORING_OFF_CQ_RING) : u->rs) == MAP_FAILED
+   || (u->se = mmap(0, u->el, PROT_READ | PROT_WRITE, MAP_SHARED, u->fd, IORING_OFF_SQES)) == MAP_FAILED)
+    goto error;
+  u->sh = (unsigned int *)((unsigned char *)u->rs + p.sq_off.head);
+  u->st = (unsigned int *)((unsigned char *)u->rs + p.sq_off.tail);
+  u->sm = (unsigned int *)((unsigned char *)u->rs + p.sq_off.ring_mask);
+  u->sa = (unsigned int *)((unsigned char *)u->rs + p.sq_off.array);
+  u->ch = (unsigned int *)((unsigned char *)u->rc + p.cq_off.head);
+  u->ct = (unsigned int *)((unsigned char *)u->rc + p.cq_off.tail);
+  u->cm = (unsigned int *)((unsigned char *)u->rc + p.cq_off.ring_mask);
+  u->ce = (struct io_uring_cqe *)((unsigned char *)u->rc + p.cq_off.cqes);
+  u->p = 0;
+  u->s = 0;
+  if ((u->ev = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    goto error;
+
+  /* fixed files, else fds */
+  u->fn = f ? f : 256;
+  if (!(u->fs = ma(0, u->fn * sizeof (*u->fs))))
+    goto error;
+  for (i = 0; i < u->fn; ++i)
+    *(u->fs + i) = -1;
+  if (reg(u->fd, IORING_REGISTER_FILES, u->fs, u->fn) < 0)
+    u->fn = 0;
+
+  /* provided buffers, else a receive per input() */
+  if ((u->bn = b)) {
+    struct io_uring_buf_reg r;
+
+    u->bz = z;
+    if ((u->br = mmap(0, u->bn * sizeof (struct io_uring_buf), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED
+     || !(u->bb = ma(0, (unsigned long)u->bn * u->bz)))
+      goto error;
+    memset(&r, 0, sizeof (r));
+    r.ring_addr = (unsigned long)u->br;
+    r.ring_entries = u->bn;
+    r.bgid = 0;
+    if (reg(u->fd, IORING_REGISTER_PBUF_RING, &r, 1) < 0) {
+      munmap(u->br, u->bn * sizeof (struct io_uring_buf));
+      u->br = MAP_FAILED;
+      mf(u->bb);
+      u->bb = 0;
+      u->bn = 0;
+    } else {
+      u->br->tail = 0;
+      for (i = 0; i < u->bn; ++i)
+        buf(u, i);
+    }
+  }
+  if (pthread_mutex_init(&u->m, 0))
+    goto error;
+  if (pthread_create(&u->t, a, reaper, u)) {
+    pthread_mutex_destroy(&u->m);
+    goto error;
+  }
+  return (u);
+error:
+  if (u->ev >= 0)
+    close(u->ev);
+  close(u->fd);
+  if (u->br != MAP_FAILED)
+    munmap(u->br, u->bn * sizeof (struct io_uring_buf));
+  mf(u->bb);
+  if (u->se != MAP_FAILED)
+    munmap(u->se, u->el);
+  if (u->cl && u->rc != MAP_FAILED)
+    munmap(u->rc, u->cl);
+  if (u->rs != MAP_FAILED)
+    munmap(u->rs, u->rl);
+  mf(u->fs);
+  mf(u);
+  return (0);
+}
+
+void
+chanBlbTrnUringDel(
+  chanBlbTrnUring_t *u
+){
+  struct io_uring_sqe e;
+
+  if (!u)
+    return;
+  memset(&e, 0, sizeof (e));
+  e.opcode = IORING_OP_NOP;
+  e.fd = -1;
+  e.user_data = 0;
+  pthread_mutex_lock(&u->m);
+  put(u, &e);
+  pthread_mutex_unlock(&u->m);
+  pthread_join(u->t, 0);
+  pthread_mutex_destroy(&u->m);
+  close(u->ev);
+  close(u->fd);
+  if (u->bn) {
+    munmap(u->br, u->bn * sizeof (struct io_uring_buf));
+    u->mf(u->bb);
+  }
+  munmap(u->se, u->el);
+  if (u->cl)
+    munmap(u->rc, u->cl);
+  munmap(u->rs, u->rl);
+  u->mf(u->fs);
+  u->mf(u);
+}
+
+#define V ((struct ctx *)v)
+
+void *
+chanBlbTrnUringCtx(
+  chanBlbTrnUring_t *u
+){
+  void *v;
+
+  if (!u)
+    return (0);
+  u->mf(u->ma(0, 1)); /* force exception here and now */
+  if ((v = u->ma(0, sizeof (struct ctx)))) {
+    V->u = u;
+    V->q = 0;
+    V->ri.u = V->ro.u = u;
+    V->ri.x = V->ro.x = 0;
+    if (pthread_cond_init(&V->ri.c, 0)) {
+      u->mf(v);
+      return (0);
+    }
+    if (pthread_cond_init(&V->ro.c, 0)) {
+      pthread_cond_destroy(&V->ri.c);
+      u->mf(v);
+      return (0);
+    }
+    V->qh = V->qn = 0;
+    V->i = V->o = -1;
+    V->si = V->so = -1;
+    V->dg = 0;
+    V->am = 0;
+  }
+  return (v);
+}
+
+void *
+chanBlbTrnUringInputCtx(
+  void *v
+ ,int f
+ ,int d
+){
+  V->i = f;
+  V->si = f == V->o ? V->so : slot(V->u, f);
+  if (d && V->u->bn && (V->q = V->u->ma(0, (V->u->bn + 1) * sizeof (*V->q))))
+    V->dg = 1;
+  return (v);
+}
+
+unsigned int
+chanBlbTrnUringInput(
+  void *v
+ ,unsigned char *b
+ ,unsigned int l
+){
+  struct io_uring_sqe e;
+  int r;
+
+  if (V->dg) {
+    struct cqe *c;
+    int k;
+
+    k = 0;
+    r = 0;
+    pthread_mutex_lock(&V->u->m);
+    pthread_cleanup_push((void(*)(void*))pthread_mutex_unlock, &V->u->m);
+    for (;;) {
+      if (V->qn) {
+        c = V->q + V->qh;
+        V->qh = (V->qh + 1) % (V->u->bn + 1);
+        --V->qn;
+        if (c->r >= 0 && c->f & IORING_CQE_F_BUFFER) {
+          r = (unsigned int)c->r < l ? c->r : (int)l;
+          memcpy(b, V->u->bb + (unsigned long)(c->f >> IORING_CQE_BUFFER_SHIFT) * V->u->bz, r);
+          buf(V->u, c->f >> IORING_CQE_BUFFER_SHIFT);
+          break;
+        }
+        if (c->r != -ENOBUFS) /* end or failure */
+          break;
+        if (!V->am && !V->qn) { /* provided buffers are all queued, receive one */
+          k = 1;
+          break;
+        }
+        continue;
+      }
+      if (!V->am) {
+        memset(&e, 0, sizeof (e));
+        e.opcode = IORING_OP_RECV;
+        e.fd = V->si >= 0 ? V->si : V->i;
+        e.flags = IOSQE_BUFFER_SELECT | (V->si >= 0 ? IOSQE_FIXED_FILE : 0);
+        e.ioprio = IORING_RECV_MULTISHOT;
+        e.buf_group = 0;
+        e.user_data = (unsigned long)&V->ri;
+        V->ri.x = V;
+        V->am = 1;
+        put(V->u, &e);
+      }
+      pthread_cond_wait(&V->ri.c, &V->u->m);
+    }
+    if (k)
+      V->ri.x = 0;
+    pthread_cleanup_pop(1);
+    if (!k)
+      return (r > 0 ? r : 0);
+  }
+  memset(&e, 0, sizeof (e));
+  e.opcode = V->dg ? IORING_OP_RECV : IORING_OP_READ;
+  e.fd = V->si >= 0 ? V->si : V->i;
+  e.flags = V->si >= 0 ? IOSQE_FIXED_FILE : 0;
+  e.off = V->dg ? 0 : (unsigned long)-1;
+  e.addr = (unsigned long)b;
+  e.len = l;
+  if ((r = req(&V->ri, &e)) < 0)
+    r = 0;
+  return (r);
+}
+
+unsigned int
+chanBlbTrnUringInputAvail(
+  void *v
+){
+  int i;
+
+  if (ioctl(V->i, FIONREAD, &i) < 0 || i < 0)
+    i = 0;
+  return (i);
+}
+
+void
+chanBlbTrnUringInputClose(
+  void *v
+){
+  struct io_uring_sqe e;
+  struct cqe *c;
+  int s;
+
+  if (V->dg) {
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &s);
+    pthread_mutex_lock(&V->u->m);
+    if (V->am) {
+      memset(&e, 0, sizeof (e));
+      e.opcode = IORING_OP_ASYNC_CANCEL;
+      e.fd = -1;
+      e.addr = (unsigned long)&V->ri;
+      e.user_data = 1;
+      put(V->u, &e);
+      while (V->am)
+        pthread_cond_wait(&V->ri.c, &V->u->m);
+    }
+    for (; V->qn; --V->qn, V->qh = (V->qh + 1) % (V->u->bn + 1))
+      if ((c = V->q + V->qh)->r >= 0 && c->f & IORING_CQE_F_BUFFER)
+        buf(V->u, c->f >> IORING_CQE_BUFFER_SHIFT);
+    pthread_mutex_unlock(&V->u->m);
+    pthread_setcancelstate(s, 0);
+  }
+  if (V->i >= 0 && V->i != V->o) {
+    unslot(V->u, V->si);
+    close(V->i);
+  }
+}
+
+void *
+chanBlbTrnUringOutputCtx(
+  void *v
+ ,int f
+){
+  V->o = f;
+  V->so = f == V->i ? V->si : slot(V->u, f);
+  return (v);
+}
+
+unsigned int
+chanBlbTrnUringOutput(
+  void *v
+ ,const unsigned char *b
+ ,unsigned int l
+){
+  struct io_uring_sqe e;
+  int i;
+
+  memset(&e, 0, sizeof (e));
+  e.opcode = IORING_OP_WRITE;
+  e.fd = V->so >= 0 ? V->so : V->o;
+  e.flags = V->so >= 0 ? IOSQE_FIXED_FILE : 0;
+  e.off = (unsigned long)-1;
+  e.addr = (unsigned long)b;
+  e.len = l;
+  if ((i = req(&V->ro, &e)) < 0)
+    i = 0;
+  return (i);
+}
+
+unsigned int
+chanBlbTrnUringOutputv(
+  void *v
+ ,const struct iovec *d
+ ,int n
+){
+  struct io_uring_sqe e;
+  int i;
+
+  memset(&e, 0, sizeof (e));
+  e.opcode = IORING_OP_WRITEV;
+  e.fd = V->so >= 0 ? V->so : V->o;
+  e.flags = V->so >= 0 ? IOSQE_FIXED_FILE : 0;
+  e.off = (unsigned long)-1;
+  e.addr = (unsigned long)d;
+  e.len = n;
+  if ((i = req(&V->ro, &e)) < 0)
+    i = 0;
+  return (i);
+}
+
+void
+chanBlbTrnUringOutputClose(
+  void *v
+){
+  if (V->o >= 0 && V->o != V->i) {
+    unslot(V->u, V->so);
+    close(V->o);
+  }
+}
+
+void
+chanBlbTrnUringFinalClose(
+  void *v
+){
+  if (V->i == V->o && V->i >= 0) {
+    unslot(V->u, V->si);
+    close(V->i);
+  }
+  pthread_cond_destroy(&V->ro.c);
+  pthread_cond_destroy(&V->ri.c);
+  V->u->mf(V->q);
+  V->u->mf(v);
+}
+
+#undef V
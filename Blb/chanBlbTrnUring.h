@@ -0,0 +1,121 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANBLBTRNURING_H__
+#define __CHANBLBTRNURING_H__
+
+struct iovec;
+
+/* a Linux io_uring, shared by the contexts made with it
+ *
+ * Each input() and output() is a request on the ring, a thread of the ring submits the requests
+ * of concurrent bridges together, by one io_uring_enter(), and reaps their completions.
+ * fds are fixed files (while there are free slots), and a datagram input is a multishot receive
+ * into the ring's provided buffers (ended by the input close, not by shutdown()).
+ *
+ * entries: submission queue entries (0 for 256)
+ * files: fixed file slots (0 for 256)
+ * buffers: provided buffers for datagram input, a power of 2 (0 for none, a receive per input())
+ * size: octets per provided buffer (the largest datagram)
+ *
+ * return 0 on failure (e.g. no io_uring in the kernel, use chanBlbTrnFd)
+ */
+typedef struct chanBlbTrnUring chanBlbTrnUring_t;
+
+chanBlbTrnUring_t *
+chanBlbTrnUringNew(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,unsigned int entries
+ ,unsigned int files
+ ,unsigned int buffers
+ ,unsigned int size
+ ,pthread_attr_t *attr
+);
+
+/* after the final close of every context made with it */
+/* calling with 0 is a harmless no-op */
+void
+chanBlbTrnUringDel(
+  chanBlbTrnUring_t *ring
+);
+
+/* like chanBlbTrnFd, on a ring */
+void *
+chanBlbTrnUringCtx(
+  chanBlbTrnUring_t *ring
+);
+
+/* non-zero datagram for a multishot receive (with provided buffers) */
+void *
+chanBlbTrnUringInputCtx(
+  void *context
+ ,int inputFd
+ ,int datagram
+);
+
+unsigned int
+chanBlbTrnUringInput(
+  void *inputCtx
+ ,unsigned char *buffer
+ ,unsigned int length
+);
+
+unsigned int
+chanBlbTrnUringInputAvail(
+  void *inputCtx
+);
+
+void
+chanBlbTrnUringInputClose(
+  void *inputCtx
+);
+
+void *
+chanBlbTrnUringOutputCtx(
+  void *context
+ ,int outputFd
+);
+
+unsigned int
+chanBlbTrnUringOutput(
+  void *outputCtx
+ ,const unsigned char *buffer
+ ,unsigned int length
+);
+
+unsigned int
+chanBlbTrnUringOutputv(
+  void *outputCtx
+ ,const struct iovec *iov
+ ,int iovcnt
+);
+
+void
+chanBlbTrnUringOutputClose(
+  void *outputCtx
+);
+
+void
+chanBlbTrnUringFinalClose(
+  void *v
+);
+
+#endif /* __CHANBLBTRNURING_H__ */
@@ -0,0 +1,288 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#include "chan.h"
+#include "chanStrCODEL.h"
+
+struct chanStrCODELe {
+  void *v;              /* item */
+  unsigned long long t; /* Put time, ns */
+};
+
+struct chanStrCODELc {
+  void (*f)(void *); /* free routine */
+  void (*d)(void *); /* item deallocation routine */
+  void (*m)(void *); /* item mark routine */
+  chanStrCODELs_t *z; /* stats */
+  struct chanStrCODELe *q; /* circular store */
+  unsigned long long a; /* first above target time, ns */
+  unsigned long long x; /* next drop time, ns */
+  unsigned long long j; /* last sojourn, ns */
+  unsigned long g;   /* target, ns */
+  unsigned long l;   /* interval, ns */
+  unsigned int k;    /* drop count */
+  unsigned int p;    /* previous drop count */
+  unsigned int s;    /* store size */
+  unsigned int h;    /* store head */
+  unsigned int t;    /* store tail */
+  unsigned int n;    /* items */
+  int r;             /* dropping */
+};
+
+#define C ((struct chanStrCODELc *)c)
+
+#define STS(f) do if (C->z) __atomic_fetch_add(&C->z->f, 1, __ATOMIC_RELAXED); while (0)
+
+static unsigned long long
+now(
+  void
+){
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return ((unsigned long long)t.tv_sec * 1000000000 + t.tv_nsec);
+}
+
+/* integer square root */
+static unsigned long long
+isqrt(
+  unsigned long long v
+){
+  unsigned long long r;
+  unsigned long long b;
+
+  for (r = 0, b = 1ULL << 62; b > v; b >>= 2);
+  for (; b; b >>= 2)
+    if (v >= r + b) {
+      v -= r + b;
+      r = (r >> 1) + b;
+    } else
+      r >>= 1;
+  return (r);
+}
+
+/* next drop time, interval / sqrt(count) after t */
+static unsigned long long
+law(
+  void *c
+ ,unsigned long long t
+){
+  return (t + (unsigned long long)C->l * 1024 / isqrt((unsigned long long)C->k << 20));
+}
+
+/* get the head item, return non-zero if it may be dropped */
+static int
+pop(
+  void *c
+ ,unsigned long long t
+ ,void **v
+){
+  unsigned long long j;
+  unsigned int i;
+
+  *v = C->q[C->h].v;
+  C->j = j = t > C->q[C->h].t ? t - C->q[C->h].t : 0;
+  if (++C->h == C->s)
+    C->h = 0;
+  --C->n;
+  if (C->z) {
+    for (i = 0; i < 63 && j >> i; ++i);
+    __atomic_fetch_add(&C->z->hst[i], 1, __ATOMIC_RELAXED);
+  }
+  if (j < C->g || !C->n) {
+    C->a = 0;
+    return (0);
+  }
+  if (!C->a) {
+    C->a = t + C->l;
+    return (0);
+  }
+  return (t >= C->a);
+}
+
+/* drop (or mark) an item, return non-zero if it was dropped */
+static int
+drop(
+  void *c
+ ,void *v
+){
+  if (C->m || !C->d) {
+    if (C->m)
+      C->m(v);
+    STS(mark);
+    return (0);
+  }
+  C->d(v);
+  STS(drop);
+  return (1);
+}
+
+static void
+chanStrCODELd(
+  void *c
+ ,chanSs_t s
+){
+  if (!c)
+    return;
+  if (C->d)
+    for (; C->n; --C->n) {
+      C->d(C->q[C->h].v);
+      if (++C->h == C->s)
+        C->h = 0;
+    }
+  C->f(C->q);
+  C->f(c);
+  (void)s; /* not needed */
+}
+
+static chanSs_t
+chanStrCODELi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  unsigned long long t;
+  unsigned int i;
+  int k;
+
+  if (!c)
+    return (0);
+  t = now();
+  if (o == chanSoPut) {
+    C->q[C->t].v = *v;
+    C->q[C->t].t = t;
+    if (++C->t == C->s)
+      C->t = 0;
+    ++C->n;
+    STS(put);
+    if (C->n == C->s)
+      return (chanSsCanGet);
+  } else {
+    k = pop(c, t, v);
+    if (C->r) {
+      if (!k)
+        C->r = 0;
+      while (C->r && (t >= C->x || C->j > C->l)) {
+        ++C->k;
+        if (!drop(c, *v)) {
+          C->x = law(c, C->x);
+          break;
+        }
+        if (!pop(c, t, v))
+          C->r = 0;
+        else
+          C->x = law(c, C->x);
+      }
+    } else if (k) {
+      C->r = 1;
+      i = C->k - C->p;
+      C->k = i > 1 && (long long)(t - C->x) < (long long)(16ULL * C->l) ? i : 1;
+      C->p = C->k;
+      C->x = law(c, t);
+      if (drop(c, *v))
+        pop(c, t, v);
+    }
+    STS(get);
+    if (!C->n)
+      return (chanSsCanPut);
+  }
+  return (chanSsCanGet | chanSsCanPut);
+  (void)w;
+}
+
+#undef STS
+#undef C
+
+unsigned long long
+chanStrCODELpct(
+  chanStrCODELs_t *z
+ ,unsigned int p
+){
+  unsigned long long n;
+  unsigned long long k;
+  unsigned int i;
+
+  if (!z || !p || p > 100)
+    return (0);
+  for (n = 0, i = 0; i < 64; ++i)
+    n += __atomic_load_n(&z->hst[i], __ATOMIC_RELAXED);
+  if (!n)
+    return (0);
+  n = (n * p + 99) / 100;
+  for (k = 0, i = 0; i < 63; ++i)
+    if ((k += __atomic_load_n(&z->hst[i], __ATOMIC_RELAXED)) >= n)
+      break;
+  return (i < 63 ? 1ULL << i : ~0ULL);
+}
+
+chanSs_t
+chanStrCODELa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanStrCODELc *c;
+  unsigned int s;
+  unsigned long g;
+  unsigned long n;
+  void (*m)(void *);
+  chanStrCODELs_t *z;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  s = va_arg(l, unsigned int);
+  g = va_arg(l, unsigned long);
+  n = va_arg(l, unsigned long);
+  m = va_arg(l, void (*)(void *));
+  z = va_arg(l, chanStrCODELs_t *);
+  if (!a || !f || !s || !g || !n)
+    return (0);
+  if (!(c = a(0, sizeof (*c)))
+   || !(c->q = a(0, s * sizeof (*c->q)))) {
+    f(c);
+    return (0);
+  }
+  c->s = s;
+  c->h = c->t = c->n = 0;
+  c->a = c->x = c->j = 0;
+  c->k = c->p = 0;
+  c->r = 0;
+  c->g = g;
+  c->l = n;
+  c->m = m;
+  c->z = z;
+  c->f = f;
+  c->d = u;
+  *d = chanStrCODELd;
+  *i = chanStrCODELi;
+  *v = c;
+  return (chanSsCanPut);
+  (void)w; /* not needed */
+  (void)x; /* not needed */
+}
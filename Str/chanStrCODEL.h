@@ -0,0 +1,69 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANSTRCODEL_H__
+#define __CHANSTRCODEL_H__
+
+/* counters of a CODEL Store, each updated atomically (read them with __atomic_load_n or chanStrCODELpct) */
+typedef struct {
+  unsigned long put;    /* items put */
+  unsigned long get;    /* items got */
+  unsigned long drop;   /* items dropped (dequeue deallocation) */
+  unsigned long mark;   /* items marked */
+  unsigned long hst[64]; /* items got or dropped by sojourn, hst[i] counts [2^(i-1), 2^i) nanoseconds */
+} chanStrCODELs_t;
+
+/* return an upper bound, in nanoseconds, of a percentile (1-100) of sojourn times in stats */
+unsigned long long
+chanStrCODELpct(
+  chanStrCODELs_t *stats
+ ,unsigned int percentile
+);
+
+/* a bounded active queue management FIFO Store (CoDel)
+ *  items are time stamped on Put, their sojourn is measured on Get
+ *  when the minimum sojourn stays above target for an interval, Get drops items (with the dequeue deallocation)
+ *   at an increasing rate (interval / sqrt(drops)) till sojourn is below target again
+ *   while dropping, items with a sojourn over interval are also dropped
+ *   (a blocked producer refills the Store as fast as it drops, this bounds sojourn)
+ *  if mark is provided, items are instead marked and got (e.g. to signal the producer)
+ *   (without dequeue deallocation or mark, they are only counted as marked)
+ *  the last item in the Store is never dropped
+ *  stats, if provided, are updated
+ */
+chanSs_t
+chanStrCODELa(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/* unsigned int size */
+/* unsigned long target (nanoseconds, e.g. 5000000) */
+/* unsigned long interval (nanoseconds, e.g. 100000000) */
+/* void (*mark)(void *item) */
+/* chanStrCODELs_t *stats */
+);
+
+#endif /* __CHANSTRCODEL_H__ */
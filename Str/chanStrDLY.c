@@ -0,0 +1,297 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#include "chan.h"
+#include "chanStrTmr.h"
+#include "chanStrDLY.h"
+
+#define WB 6             /* bits of a wheel level */
+#define WS (1 << WB)     /* slots of a wheel level */
+#define WM (WS - 1)
+#define WL 4             /* levels of millisecond ticks, about 4.6 hours, then beyond */
+
+struct chanStrDLYn {
+  struct chanStrDLYn *n; /* next */
+  void *v;               /* item */
+  unsigned long long t;  /* release tick */
+};
+
+struct chanStrDLYc {
+  void (*f)(void *); /* free routine */
+  void (*d)(void *); /* item deallocation routine */
+  void (*r)(void *, struct timespec *); /* item release routine */
+  int (*w)(void *, chanSs_t); /* wake routine */
+  void *x;           /* wake closure */
+  void *k;           /* timer */
+  struct chanStrDLYn *p; /* node store */
+  struct chanStrDLYn *u; /* unused nodes */
+  struct chanStrDLYn *h; /* released head */
+  struct chanStrDLYn **e; /* released tail */
+  struct chanStrDLYn *o; /* beyond the wheel */
+  struct chanStrDLYn *l[WL][WS]; /* wheel */
+  unsigned long long c; /* current tick */
+  unsigned long long a; /* armed tick */
+  unsigned int s;    /* store size */
+  unsigned int n;    /* items */
+  unsigned int m;    /* items not released */
+};
+
+#define C ((struct chanStrDLYc *)c)
+
+static unsigned long long
+now(
+  void
+){
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return ((unsigned long long)t.tv_sec * 1000 + t.tv_nsec / 1000000);
+}
+
+/* place a node on the wheel, or release it */
+static void
+place(
+  void *c
+ ,struct chanStrDLYn *n
+){
+  unsigned long long d;
+  unsigned int i;
+
+  if (n->t <= C->c) {
+    n->n = 0;
+    *C->e = n;
+    C->e = &n->n;
+    return;
+  }
+  ++C->m;
+  d = n->t - C->c;
+  for (i = 0; i < WL && d >> (WB * (i + 1)); ++i);
+  if (i == WL) {
+    n->n = C->o;
+    C->o = n;
+  } else {
+    n->n = C->l[i][(n->t >> (WB * i)) & WM];
+    C->l[i][(n->t >> (WB * i)) & WM] = n;
+  }
+}
+
+/* advance the wheel to a tick, cascading and releasing */
+static void
+advance(
+  void *c
+ ,unsigned long long t
+){
+  struct chanStrDLYn *n;
+  struct chanStrDLYn *s;
+  unsigned long long j;
+  unsigned int i;
+
+  while (C->c < t) {
+    if (!C->m) {
+      C->c = t;
+      break;
+    }
+    j = ++C->c;
+    for (i = 1; i <= WL && !((j >> (WB * (i - 1))) & WM); ++i) {
+      if (i == WL) {
+        s = C->o;
+        C->o = 0;
+      } else {
+        s = C->l[i][(j >> (WB * i)) & WM];
+        C->l[i][(j >> (WB * i)) & WM] = 0;
+      }
+      while ((n = s)) {
+        s = n->n;
+        --C->m;
+        place(c, n);
+      }
+    }
+    s = C->l[0][j & WM];
+    C->l[0][j & WM] = 0;
+    while ((n = s)) {
+      s = n->n;
+      --C->m;
+      place(c, n);
+    }
+  }
+}
+
+/* arm the timer for the next tick that releases or cascades */
+static void
+arm(
+  void *c
+){
+  struct timespec a;
+  unsigned long long j;
+
+  if (!C->m) {
+    if (C->a) {
+      C->a = 0;
+      chanStrTmrSet(C->k, 0);
+    }
+    return;
+  }
+  for (j = C->c + 1; j & WM && !C->l[0][j & WM]; ++j);
+  if (j == C->a)
+    return;
+  C->a = j;
+  a.tv_sec = j / 1000;
+  a.tv_nsec = j % 1000 * 1000000;
+  chanStrTmrSet(C->k, &a);
+}
+
+static void
+fire(
+  void *c
+){
+  C->w(C->x, chanSsWake);
+}
+
+static void
+chanStrDLYd(
+  void *c
+ ,chanSs_t s
+){
+  struct chanStrDLYn *n;
+  unsigned int i;
+  unsigned int j;
+
+  if (!c)
+    return;
+  chanStrTmrDel(C->k);
+  if (C->d) {
+    for (n = C->h; n; n = n->n)
+      C->d(n->v);
+    for (n = C->o; n; n = n->n)
+      C->d(n->v);
+    for (i = 0; i < WL; ++i)
+      for (j = 0; j < WS; ++j)
+        for (n = C->l[i][j]; n; n = n->n)
+          C->d(n->v);
+  }
+  C->f(C->p);
+  C->f(c);
+  (void)s; /* not needed */
+}
+
+static chanSs_t
+chanStrDLYi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  struct chanStrDLYn *n;
+  struct timespec t;
+  chanSs_t s;
+
+  if (!c)
+    return (0);
+  advance(c, now());
+  if (o == chanSoPut) {
+    n = C->u;
+    C->u = n->n;
+    n->v = *v;
+    C->r(n->v, &t);
+    n->t = (unsigned long long)t.tv_sec * 1000 + (t.tv_nsec + 999999) / 1000000;
+    place(c, n);
+    ++C->n;
+  } else if (o == chanSoGet) {
+    n = C->h;
+    if (!(C->h = n->n))
+      C->e = &C->h;
+    *v = n->v;
+    n->n = C->u;
+    C->u = n;
+    --C->n;
+  }
+  arm(c);
+  s = 0;
+  if (C->n < C->s)
+    s |= chanSsCanPut;
+  if (C->h)
+    s |= chanSsCanGet;
+  if (!s)
+    s = chanSsWake;
+  return (s);
+  (void)w;
+}
+
+#undef C
+
+chanSs_t
+chanStrDLYa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanStrDLYc *c;
+  unsigned int s;
+  void (*r)(void *, struct timespec *);
+  unsigned int j;
+  unsigned int k;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  s = va_arg(l, unsigned int);
+  r = va_arg(l, void (*)(void *, struct timespec *));
+  if (!a || !f || !w || !s || !r)
+    return (0);
+  if (!(c = a(0, sizeof (*c))))
+    return (0);
+  if (!(c->p = a(0, s * sizeof (*c->p)))) {
+    f(c);
+    return (0);
+  }
+  if (!(c->k = chanStrTmrNew(a, f, fire, c))) {
+    f(c->p);
+    f(c);
+    return (0);
+  }
+  for (j = 0; j < s; ++j)
+    (c->p + j)->n = j + 1 < s ? c->p + j + 1 : 0;
+  c->u = c->p;
+  c->h = c->o = 0;
+  c->e = &c->h;
+  for (j = 0; j < WL; ++j)
+    for (k = 0; k < WS; ++k)
+      c->l[j][k] = 0;
+  c->c = now();
+  c->a = 0;
+  c->s = s;
+  c->n = c->m = 0;
+  c->r = r;
+  c->w = w;
+  c->x = x;
+  c->f = f;
+  c->d = u;
+  *d = chanStrDLYd;
+  *i = chanStrDLYi;
+  *v = c;
+  return (chanSsCanPut);
+}
@@ -0,0 +1,44 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANSTRDLY_H__
+#define __CHANSTRDLY_H__
+
+/* a bounded delay Store (hierarchical timing wheel)
+ *  release sets the CLOCK_MONOTONIC time an item is released, Get returns released items in release order
+ *  to the millisecond (items released in the same millisecond are in no particular order)
+ *  insert is O(1), a shared timer thread (see chanStrTmr.h) wakes the Channel when items are released
+ */
+chanSs_t
+chanStrDLYa(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/* unsigned int size */
+/* void (*release)(void *item, struct timespec *time) */
+);
+
+#endif /* __CHANSTRDLY_H__ */
@@ -18,6 +18,7 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "chan.h"
 #include "chanStrFIFO.h"
 
@@ -114,3 +115,103 @@ chanStrFIFOa(
   (void)w; /* not needed */
   (void)x; /* not needed */
 }
+
+/**********************************************************/
+
+struct chanStrFIFOvc {
+  void (*f)(void *); /* free routine */
+  void (*d)(void *); /* item deallocation routine */
+  unsigned char *q;  /* circular store of items */
+  unsigned int w;    /* item width */
+  unsigned int s;    /* store size */
+  unsigned int h;    /* store head */
+  unsigned int t;    /* store tail */
+};
+
+#define C ((struct chanStrFIFOvc *)c)
+
+static void
+chanStrFIFOvd(
+  void *c
+ ,chanSs_t s
+){
+  if (!c)
+    return;
+  if (s & chanSsCanGet && C->d)
+    do {
+      C->d(C->q + (unsigned long)C->h * C->w);
+      if (++C->h == C->s)
+        C->h = 0;
+    } while (C->h != C->t);
+  C->f(C->q);
+  C->f(c);
+}
+
+static chanSs_t
+chanStrFIFOvi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  if (!c)
+    return (0);
+  if (o == chanSoPut) {
+    memcpy(C->q + (unsigned long)C->t * C->w, v, C->w);
+    if (++C->t == C->s)
+      C->t = 0;
+    if (C->t == C->h)
+      return (chanSsCanGet);
+  } else {
+    memcpy(v, C->q + (unsigned long)C->h * C->w, C->w);
+    if (++C->h == C->s)
+      C->h = 0;
+    if (C->h == C->t)
+      return (chanSsCanPut);
+  }
+  return (chanSsCanGet | chanSsCanPut);
+  (void) w;
+}
+
+#undef C
+
+chanSs_t
+chanStrFIFOva(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanStrFIFOvc *c;
+  unsigned int s;
+  unsigned int n;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  s = va_arg(l, unsigned int);
+  n = va_arg(l, unsigned int);
+  if (!a || !f || !s || !n)
+    return (0);
+  if (!(c = a(0, sizeof (*c)))
+   || !(c->q = a(0, (unsigned long)s * n))) {
+    f(c);
+    return (0);
+  }
+  c->w = n;
+  c->s = s;
+  c->h = c->t = 0;
+  c->f = f;
+  c->d = u;
+  *d = chanStrFIFOvd;
+  *i = chanStrFIFOvi;
+  *v = c;
+  return (chanSsCanPut);
+  (void)w; /* not needed */
+  (void)x; /* not needed */
+}
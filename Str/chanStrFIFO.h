@@ -35,4 +35,23 @@ chanStrFIFOa(
 /* unsigned int size */
 );
 
+/* a value Store copies items of width octets into its own slots
+ *  Put copies from, and Get copies to, the chanOp val (the item itself, not a pointer to one)
+ *  the item deallocation routine is called with the address of each item remaining in the Store
+ */
+chanSs_t
+chanStrFIFOva(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/* unsigned int size */
+/* unsigned int width */
+);
+
 #endif /* __CHANSTRFIFO_H__ */
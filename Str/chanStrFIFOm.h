@@ -0,0 +1,119 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANSTRFIFOM_H__
+#define __CHANSTRFIFOM_H__
+
+/* compile time specialized FIFO Stores, generated in the including file
+ *
+ * CHANSTRFIFOM(name, size) generates a pointer FIFO Store:
+ *  static chanSs_t namea(...), for chanCreate(dealloc, namea) (no additional arguments)
+ * CHANSTRFIFOMV(name, type, size) generates a value FIFO Store of type items (see chanStrFIFOva):
+ *  Put copies from, and Get copies to, the chanOp val (a type *)
+ *  the item deallocation routine is called with the address of each item remaining in the Store
+ *
+ * size is a power of two, so the ring is indexed by masking free running offsets,
+ * and the items are allocated with the Store closure.
+ */
+
+#define CHANSTRFIFOM_(N,T,S,X) \
+typedef char N##p[(S) && !((S) & ((S) - 1)) ? 1 : -1]; /* size is a power of two */\
+struct N##c {\
+  void (*f)(void *); /* free routine */\
+  void (*d)(void *); /* item deallocation routine */\
+  unsigned int h;    /* store head */\
+  unsigned int t;    /* store tail */\
+  T q[S];            /* circular store */\
+};\
+static void \
+N##d(\
+  void *c\
+ ,chanSs_t s\
+){\
+  struct N##c *C;\
+\
+  if (!(C = c))\
+    return;\
+  if (C->d)\
+    while (C->h != C->t)\
+      X;\
+  C->f(c);\
+  (void)s; /* not needed */\
+}\
+static chanSs_t \
+N##i(\
+  void *c\
+ ,chanSo_t o\
+ ,chanSw_t w\
+ ,void **v\
+){\
+  struct N##c *C;\
+\
+  if (!(C = c))\
+    return (0);\
+  if (o == chanSoPut) {\
+    C->q[C->t++ & ((S) - 1)] = *(T *)v;\
+    if (C->t - C->h == (S))\
+      return (chanSsCanGet);\
+  } else {\
+    *(T *)v = C->q[C->h++ & ((S) - 1)];\
+    if (C->h == C->t)\
+      return (chanSsCanPut);\
+  }\
+  return (chanSsCanGet | chanSsCanPut);\
+  (void)w;\
+}\
+static chanSs_t \
+N##a(\
+  void *(*a)(void *, unsigned long)\
+ ,void (*f)(void *)\
+ ,void (*u)(void *)\
+ ,int (*w)(void *, chanSs_t)\
+ ,void *x\
+ ,chanSd_t *d\
+ ,chanSi_t *i\
+ ,void **v\
+ ,va_list l\
+){\
+  struct N##c *c;\
+\
+  if (!v)\
+    return (0);\
+  *v = 0;\
+  if (!a || !f\
+   || !(c = a(0, sizeof (*c))))\
+    return (0);\
+  c->h = c->t = 0;\
+  c->f = f;\
+  c->d = u;\
+  *d = N##d;\
+  *i = N##i;\
+  *v = c;\
+  return (chanSsCanPut);\
+  (void)w; /* not needed */\
+  (void)x; /* not needed */\
+  (void)l; /* not needed */\
+}
+
+#define CHANSTRFIFOM(N,S) CHANSTRFIFOM_(N, void *, S, C->d(C->q[C->h++ & ((S) - 1)]))
+
+#define CHANSTRFIFOMV(N,T,S) CHANSTRFIFOM_(N, T, S, C->d(&C->q[C->h++ & ((S) - 1)]))
+
+#endif /* __CHANSTRFIFOM_H__ */
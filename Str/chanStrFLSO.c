@@ -18,6 +18,7 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "chan.h"
 #include "chanStrFLSO.h"
 
@@ -147,3 +148,132 @@ chanStrFLSOa(
   (void)w; /* not needed */
   (void)x; /* not needed */
 }
+
+/**********************************************************/
+
+struct chanStrFLSOvc {
+  void (*f)(void *); /* free routine */
+  void (*d)(void *); /* item deallocation routine */
+  unsigned char *q;  /* circular store of items */
+  unsigned int w;    /* item width */
+  unsigned int m;    /* store max */
+  unsigned int s;    /* store size */
+  unsigned int h;    /* store head */
+  unsigned int t;    /* store tail */
+};
+
+#define C ((struct chanStrFLSOvc *)c)
+
+static void
+chanStrFLSOvd(
+  void *c
+ ,chanSs_t s
+){
+  if (!c)
+    return;
+  if (s & chanSsCanGet && C->d)
+    do {
+      C->d(C->q + (unsigned long)C->h * C->w);
+      if (++C->h == C->s)
+        C->h = 0;
+    } while (C->h != C->t);
+  C->f(C->q);
+  C->f(c);
+}
+
+static chanSs_t
+chanStrFLSOvi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  if (!c)
+    return (0);
+  if (o == chanSoPut) {
+    if (C->t == C->h
+     && (w & chanSwNoGet)
+     && C->s > 2) {
+      --C->s;
+      C->h = C->t = 0;
+    }
+    memcpy(C->q + (unsigned long)C->t * C->w, v, C->w);
+    if (++C->t == C->s)
+      C->t = 0;
+    if (C->t == C->h) {
+      if (!(w & chanSwNoGet)
+       && C->s < C->m) {
+        memmove(C->q + (unsigned long)(C->t + 1) * C->w, C->q + (unsigned long)C->t * C->w, (unsigned long)(C->s - C->t) * C->w);
+        ++C->s;
+        ++C->h;
+      } else
+        return (chanSsCanGet);
+    }
+  } else {
+    if (C->t == C->h
+     && !(w & chanSwNoPut)
+     && C->s < C->m) {
+      memmove(C->q + (unsigned long)(C->t + 1) * C->w, C->q + (unsigned long)C->t * C->w, (unsigned long)(C->s - C->t) * C->w);
+      ++C->s;
+      ++C->h;
+    }
+    memcpy(v, C->q + (unsigned long)C->h * C->w, C->w);
+    if (++C->h == C->s)
+      C->h = 0;
+    if (C->h == C->t) {
+      if ((w & chanSwNoPut)
+       && C->s > 2) {
+        --C->s;
+        C->h = C->t = 0;
+      }
+      return (chanSsCanPut);
+    }
+  }
+  return (chanSsCanGet | chanSsCanPut);
+}
+
+#undef C
+
+chanSs_t
+chanStrFLSOva(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanStrFLSOvc *c;
+  unsigned int m;
+  unsigned int s;
+  unsigned int n;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  m = va_arg(l, unsigned int);
+  s = va_arg(l, unsigned int);
+  n = va_arg(l, unsigned int);
+  if (!a || !f || !s || m < s || !n)
+    return (0);
+  if (!(c = a(0, sizeof (*c)))
+   || !(c->q = a(0, (unsigned long)m * n))) {
+    f(c);
+    return (0);
+  }
+  c->w = n;
+  c->m = m;
+  c->s = s;
+  c->h = c->t = 0;
+  c->f = f;
+  c->d = u;
+  *d = chanStrFLSOvd;
+  *i = chanStrFLSOvi;
+  *v = c;
+  return (chanSsCanPut);
+  (void)w; /* not needed */
+  (void)x; /* not needed */
+}
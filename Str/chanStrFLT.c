@@ -0,0 +1,220 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#include "chan.h"
+#include "chanStrFLT.h"
+
+struct chanStrFLTe {
+  void *v;              /* item */
+  unsigned long long t; /* Put time, ns */
+};
+
+struct chanStrFLTc {
+  void (*f)(void *); /* free routine */
+  void (*d)(void *); /* item deallocation routine */
+  chanStrFLTs_t *z;  /* stats */
+  struct chanStrFLTe *q; /* circular store */
+  unsigned long long e; /* smoothed sojourn, ns */
+  unsigned long long g; /* smoothed time between Gets, ns */
+  unsigned long long l; /* last Get, ns */
+  unsigned long long x; /* store size, 24.8 fixed point */
+  unsigned long p;   /* target, ns */
+  unsigned int k;    /* smoothing */
+  unsigned int m;    /* store max */
+  unsigned int s;    /* store size */
+  unsigned int h;    /* store head */
+  unsigned int t;    /* store tail */
+  unsigned int n;    /* items */
+};
+
+#define C ((struct chanStrFLTc *)c)
+
+#define STS(f,v) do if (C->z) __atomic_store_n(&C->z->f, (v), __ATOMIC_RELAXED); while (0)
+
+static unsigned long long
+now(
+  void
+){
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return ((unsigned long long)t.tv_sec * 1000000000 + t.tv_nsec);
+}
+
+/* smooth v toward a */
+static unsigned long long
+ewma(
+  void *c
+ ,unsigned long long v
+ ,unsigned long long a
+){
+  if (a > v)
+    return (v + ((a - v) >> C->k));
+  return (v - ((v - a) >> C->k));
+}
+
+/* resize from the fixed point size */
+static void
+size(
+  void *c
+){
+  unsigned int s;
+
+  if (C->x < 1 << 8)
+    C->x = 1 << 8;
+  else if (C->x > (unsigned long long)C->m << 8)
+    C->x = (unsigned long long)C->m << 8;
+  if ((s = C->x >> 8) == C->s)
+    return;
+  if (C->z) {
+    if (s > C->s)
+      __atomic_fetch_add(&C->z->grow, 1, __ATOMIC_RELAXED);
+    else
+      __atomic_fetch_add(&C->z->shrink, 1, __ATOMIC_RELAXED);
+  }
+  C->s = s;
+  STS(size, s);
+}
+
+static void
+chanStrFLTd(
+  void *c
+ ,chanSs_t s
+){
+  if (!c)
+    return;
+  if (C->d)
+    for (; C->n; --C->n) {
+      C->d(C->q[C->h].v);
+      if (++C->h == C->m)
+        C->h = 0;
+    }
+  C->f(C->q);
+  C->f(c);
+  (void)s; /* not needed */
+}
+
+static chanSs_t
+chanStrFLTi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  unsigned long long t;
+  unsigned long long j;
+  int f;
+
+  if (!c)
+    return (0);
+  t = now();
+  if (o == chanSoPut) {
+    C->q[C->t].v = *v;
+    C->q[C->t].t = t;
+    if (++C->t == C->m)
+      C->t = 0;
+    ++C->n;
+  } else {
+    f = C->n >= C->s;
+    *v = C->q[C->h].v;
+    j = t > C->q[C->h].t ? t - C->q[C->h].t : 0;
+    if (++C->h == C->m)
+      C->h = 0;
+    --C->n;
+    C->e = ewma(c, C->e, j);
+    STS(sojourn, C->e);
+    if (C->l) {
+      C->g = ewma(c, C->g, t - C->l);
+      STS(interval, C->g);
+    }
+    C->l = t;
+    if (C->g)
+      C->x = ewma(c, C->x, ((unsigned long long)C->p << 8) / C->g);
+    if (f && !(w & chanSwNoPut) && C->e < C->p)
+      C->x += 1 << 8;
+    size(c);
+  }
+  if (!C->n)
+    return (chanSsCanPut);
+  if (C->n >= C->s)
+    return (chanSsCanGet);
+  return (chanSsCanGet | chanSsCanPut);
+}
+
+#undef STS
+#undef C
+
+chanSs_t
+chanStrFLTa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanStrFLTc *c;
+  unsigned int m;
+  unsigned int s;
+  unsigned long p;
+  unsigned int k;
+  chanStrFLTs_t *z;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  m = va_arg(l, unsigned int);
+  s = va_arg(l, unsigned int);
+  p = va_arg(l, unsigned long);
+  k = va_arg(l, unsigned int);
+  z = va_arg(l, chanStrFLTs_t *);
+  if (!a || !f || !s || m < s || !p || k > 16)
+    return (0);
+  if (!(c = a(0, sizeof (*c)))
+   || !(c->q = a(0, m * sizeof (*c->q)))) {
+    f(c);
+    return (0);
+  }
+  c->m = m;
+  c->s = s;
+  c->x = (unsigned long long)s << 8;
+  c->h = c->t = c->n = 0;
+  c->e = c->g = c->l = 0;
+  c->p = p;
+  c->k = k;
+  c->z = z;
+  if (z) {
+    z->size = s;
+    z->sojourn = z->interval = 0;
+    z->grow = z->shrink = 0;
+  }
+  c->f = f;
+  c->d = u;
+  *d = chanStrFLTd;
+  *i = chanStrFLTi;
+  *v = c;
+  return (chanSsCanPut);
+  (void)w; /* not needed */
+  (void)x; /* not needed */
+}
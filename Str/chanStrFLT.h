@@ -0,0 +1,58 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANSTRFLT_H__
+#define __CHANSTRFLT_H__
+
+/* observations and decisions of a FLT Store, each updated atomically (read them with __atomic_load_n) */
+typedef struct {
+  unsigned long size;     /* current size */
+  unsigned long sojourn;  /* smoothed sojourn, ns */
+  unsigned long interval; /* smoothed time between Gets, ns */
+  unsigned long grow;     /* size increases */
+  unsigned long shrink;   /* size decreases */
+} chanStrFLTs_t;
+
+/* a maximum sized, latency target, Channel FIFO Store
+ *  items are time stamped on Put, sojourn and the time between Gets are smoothed (1/2^smoothing EWMA)
+ *  size is steered to what drains in target (target / time between Gets), also smoothed,
+ *  and grows early when Puts wait on a full Store with sojourn under target
+ *  size only limits Puts, items are never moved
+ *  stats, if provided, are updated
+ */
+chanSs_t
+chanStrFLTa(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/* unsigned int max */
+/* unsigned int size */
+/* unsigned long target (nanoseconds) */
+/* unsigned int smoothing (e.g. 3) */
+/* chanStrFLTs_t *stats */
+);
+
+#endif /* __CHANSTRFLT_H__ */
@@ -0,0 +1,191 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "chan.h"
+#include "chanStrKEY.h"
+
+struct chanStrKEYe {
+  void *v;           /* item */
+  unsigned long h;   /* key hash */
+};
+
+struct chanStrKEYc {
+  void (*f)(void *); /* free routine */
+  void (*d)(void *); /* item deallocation routine */
+  const void *(*k)(void *, unsigned int *); /* item key routine */
+  struct chanStrKEYe *q; /* circular store */
+  unsigned int *x;   /* index, linear probed, store offset + 1 or 0 */
+  unsigned int m;    /* index mask */
+  unsigned int s;    /* store size */
+  unsigned int h;    /* store head */
+  unsigned int t;    /* store tail */
+  unsigned int n;    /* items */
+};
+
+#define C ((struct chanStrKEYc *)c)
+
+/* FNV-1a */
+static unsigned long
+hash(
+  const unsigned char *k
+ ,unsigned int l
+){
+  unsigned long h;
+
+  for (h = 2166136261UL; l; --l, ++k)
+    h = (h ^ *k) * 16777619UL;
+  return (h);
+}
+
+static void
+chanStrKEYd(
+  void *c
+ ,chanSs_t s
+){
+  if (!c)
+    return;
+  if (C->d)
+    for (; C->n; --C->n) {
+      C->d(C->q[C->h].v);
+      if (++C->h == C->s)
+        C->h = 0;
+    }
+  C->f(C->x);
+  C->f(C->q);
+  C->f(c);
+  (void)s; /* not needed */
+}
+
+static chanSs_t
+chanStrKEYi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  const void *k;
+  const void *j;
+  unsigned long h;
+  unsigned int l;
+  unsigned int n;
+  unsigned int i;
+  unsigned int e;
+
+  if (!c)
+    return (0);
+  if (o == chanSoPut) {
+    k = C->k(*v, &l);
+    h = hash(k, l);
+    for (i = h & C->m; (e = C->x[i]); i = (i + 1) & C->m)
+      if (C->q[e - 1].h == h
+       && (j = C->k(C->q[e - 1].v, &n))
+       && n == l
+       && !memcmp(j, k, l)) {
+        if (C->d)
+          C->d(C->q[e - 1].v);
+        C->q[e - 1].v = *v;
+        goto state;
+      }
+    C->x[i] = C->t + 1;
+    C->q[C->t].v = *v;
+    C->q[C->t].h = h;
+    if (++C->t == C->s)
+      C->t = 0;
+    ++C->n;
+  } else {
+    *v = C->q[C->h].v;
+    for (i = C->q[C->h].h & C->m; C->x[i] != C->h + 1; i = (i + 1) & C->m);
+    /* backward shift delete */
+    for (e = i; ; ) {
+      C->x[i] = 0;
+      do {
+        e = (e + 1) & C->m;
+        if (!C->x[e])
+          goto deleted;
+        n = C->q[C->x[e] - 1].h & C->m;
+      } while (i <= e ? (i < n && n <= e) : (i < n || n <= e));
+      C->x[i] = C->x[e];
+      i = e;
+    }
+deleted:
+    if (++C->h == C->s)
+      C->h = 0;
+    --C->n;
+  }
+state:
+  if (!C->n)
+    return (chanSsCanPut);
+  if (C->n == C->s)
+    return (chanSsCanGet);
+  return (chanSsCanGet | chanSsCanPut);
+  (void)w;
+}
+
+#undef C
+
+chanSs_t
+chanStrKEYa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanStrKEYc *c;
+  unsigned int s;
+  const void *(*k)(void *, unsigned int *);
+  unsigned int m;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  s = va_arg(l, unsigned int);
+  k = va_arg(l, const void *(*)(void *, unsigned int *));
+  if (!a || !f || !s || !k || s > ~0U / 4)
+    return (0);
+  for (m = 2; m < 2 * s; m <<= 1);
+  if (!(c = a(0, sizeof (*c))))
+    return (0);
+  c->x = 0;
+  if (!(c->q = a(0, s * sizeof (*c->q)))
+   || !(c->x = a(0, m * sizeof (*c->x)))) {
+    f(c->q);
+    f(c);
+    return (0);
+  }
+  memset(c->x, 0, m * sizeof (*c->x));
+  c->m = m - 1;
+  c->s = s;
+  c->h = c->t = c->n = 0;
+  c->k = k;
+  c->f = f;
+  c->d = u;
+  *d = chanStrKEYd;
+  *i = chanStrKEYi;
+  *v = c;
+  return (chanSsCanPut);
+  (void)w; /* not needed */
+  (void)x; /* not needed */
+}
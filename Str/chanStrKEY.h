@@ -0,0 +1,45 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANSTRKEY_H__
+#define __CHANSTRKEY_H__
+
+/* a bounded key coalescing FIFO Store
+ *  key returns the octets (and sets the length) of an item's key
+ *  a Put of an item with the key of an item in the Store replaces that item in place (keeping its order),
+ *   the replaced item is deallocated with the dequeue deallocation
+ *  so the Store holds only the latest item of each key, and size bounds the number of keys in flight
+ */
+chanSs_t
+chanStrKEYa(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/* unsigned int size */
+/* const void *(*key)(void *item, unsigned int *length) */
+);
+
+#endif /* __CHANSTRKEY_H__ */
@@ -35,4 +35,23 @@ chanStrLIFOa(
 /* unsigned int size */
 );
 
+/* a value Store copies items of width octets into its own slots
+ *  Put copies from, and Get copies to, the chanOp val (the item itself, not a pointer to one)
+ *  the item deallocation routine is called with the address of each item remaining in the Store
+ */
+chanSs_t
+chanStrLIFOva(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeContext
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeContext
+ ,va_list list
+/* unsigned int size */
+/* unsigned int width */
+);
+
 #endif /* __CHANSTRLIFO_H__ */
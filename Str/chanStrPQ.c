@@ -0,0 +1,150 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "chan.h"
+#include "chanStrPQ.h"
+
+struct chanStrPQe {
+  void *v;           /* item */
+  unsigned long n;   /* Put sequence */
+};
+
+struct chanStrPQc {
+  void (*f)(void *); /* free routine */
+  void (*d)(void *); /* item deallocation routine */
+  int (*c)(void *, void *); /* item comparison routine */
+  struct chanStrPQe *q; /* heap store */
+  unsigned long n;   /* next Put sequence */
+  unsigned int s;    /* store size */
+  unsigned int t;    /* store tail */
+};
+
+#define C ((struct chanStrPQc *)c)
+
+/* does entry i go before entry j */
+#define B(i,j) ((k = C->c(C->q[i].v, C->q[j].v)) < 0 || (!k && (long)(C->q[i].n - C->q[j].n) < 0))
+
+static void
+chanStrPQd(
+  void *c
+ ,chanSs_t s
+){
+  if (!c)
+    return;
+  if (s & chanSsCanGet && C->d)
+    do {
+      --C->t;
+      C->d(C->q[C->t].v);
+    } while (C->t);
+  C->f(C->q);
+  C->f(c);
+}
+
+static chanSs_t
+chanStrPQi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  struct chanStrPQe e;
+  unsigned int i;
+  unsigned int j;
+  int k;
+
+  if (!c)
+    return (0);
+  if (o == chanSoPut) {
+    i = C->t++;
+    C->q[i].v = *v;
+    C->q[i].n = C->n++;
+    for (e = C->q[i]; i; i = j) {
+      j = (i - 1) / 2;
+      if (!B(i, j))
+        break;
+      C->q[i] = C->q[j];
+      C->q[j] = e;
+    }
+    if (C->t == C->s)
+      return (chanSsCanGet);
+  } else {
+    *v = C->q[0].v;
+    if (--C->t) {
+      e = C->q[C->t];
+      C->q[0] = e;
+      for (i = 0; (j = 2 * i + 1) < C->t; i = j) {
+        if (j + 1 < C->t && B(j + 1, j))
+          ++j;
+        if (!B(j, i))
+          break;
+        C->q[i] = C->q[j];
+        C->q[j] = e;
+      }
+    } else
+      return (chanSsCanPut);
+  }
+  return (chanSsCanGet | chanSsCanPut);
+  (void)w;
+}
+
+#undef B
+#undef C
+
+chanSs_t
+chanStrPQa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanStrPQc *c;
+  unsigned int s;
+  int (*p)(void *, void *);
+
+  if (!v)
+    return (0);
+  *v = 0;
+  s = va_arg(l, unsigned int);
+  p = va_arg(l, int (*)(void *, void *));
+  if (!a || !f || !s || !p)
+    return (0);
+  if (!(c = a(0, sizeof (*c)))
+   || !(c->q = a(0, s * sizeof (*c->q)))) {
+    f(c);
+    return (0);
+  }
+  c->s = s;
+  c->t = 0;
+  c->n = 0;
+  c->c = p;
+  c->f = f;
+  c->d = u;
+  *d = chanStrPQd;
+  *i = chanStrPQi;
+  *v = c;
+  return (chanSsCanPut);
+  (void)w; /* not needed */
+  (void)x; /* not needed */
+}
@@ -0,0 +1,221 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#include "chan.h"
+#include "chanStrTmr.h"
+#include "chanStrRATE.h"
+
+struct chanStrRATEc {
+  void (*f)(void *); /* free routine */
+  void (*d)(void *); /* item deallocation routine */
+  unsigned long (*k)(void *); /* item cost routine */
+  int (*w)(void *, chanSs_t); /* wake routine */
+  void *x;           /* wake closure */
+  void *m;           /* timer */
+  void **q;          /* circular store */
+  unsigned long long p; /* theoretical arrival time, ns */
+  unsigned long long a; /* armed time, ns */
+  unsigned long r;   /* rate */
+  unsigned long b;   /* burst */
+  unsigned int s;    /* store size */
+  unsigned int h;    /* store head */
+  unsigned int t;    /* store tail */
+  unsigned int n;    /* items */
+};
+
+#define C ((struct chanStrRATEc *)c)
+
+static unsigned long long
+now(
+  void
+){
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return ((unsigned long long)t.tv_sec * 1000000000 + t.tv_nsec);
+}
+
+/* tokens an item takes */
+static unsigned long
+cost(
+  void *c
+ ,void *v
+){
+  unsigned long k;
+
+  if (!C->k || !(k = C->k(v)))
+    k = 1;
+  return (k);
+}
+
+/* ns to earn tokens */
+static unsigned long long
+earn(
+  void *c
+ ,unsigned long k
+){
+  return ((unsigned long long)k / C->r * 1000000000
+        + (unsigned long long)(k % C->r) * 1000000000 / C->r);
+}
+
+/* time the head item can be got */
+static unsigned long long
+eligible(
+  void *c
+){
+  unsigned long k;
+  unsigned long long e;
+
+  k = cost(c, C->q[C->h]);
+  if (k > C->b)
+    k = C->b;
+  e = earn(c, C->b - k);
+  return (C->p > e ? C->p - e : 0);
+}
+
+static void
+fire(
+  void *c
+){
+  C->w(C->x, chanSsWake);
+}
+
+static void
+chanStrRATEd(
+  void *c
+ ,chanSs_t s
+){
+  if (!c)
+    return;
+  chanStrTmrDel(C->m);
+  if (C->d)
+    for (; C->n; --C->n) {
+      C->d(C->q[C->h]);
+      if (++C->h == C->s)
+        C->h = 0;
+    }
+  C->f(C->q);
+  C->f(c);
+  (void)s; /* not needed */
+}
+
+static chanSs_t
+chanStrRATEi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  struct timespec a;
+  unsigned long long e;
+  unsigned long long t;
+  chanSs_t s;
+
+  if (!c)
+    return (0);
+  t = now();
+  if (o == chanSoPut) {
+    C->q[C->t] = *v;
+    if (++C->t == C->s)
+      C->t = 0;
+    ++C->n;
+  } else if (o == chanSoGet) {
+    *v = C->q[C->h];
+    if (++C->h == C->s)
+      C->h = 0;
+    --C->n;
+    C->p = (C->p > t ? C->p : t) + earn(c, cost(c, *v));
+  }
+  s = 0;
+  if (C->n < C->s)
+    s |= chanSsCanPut;
+  if (C->n) {
+    if ((e = eligible(c)) <= t) {
+      s |= chanSsCanGet;
+      C->a = 0;
+    } else if (e != C->a) {
+      C->a = e;
+      a.tv_sec = e / 1000000000;
+      a.tv_nsec = e % 1000000000;
+      chanStrTmrSet(C->m, &a);
+    }
+  }
+  if (!s)
+    s = chanSsWake;
+  return (s);
+  (void)w;
+}
+
+#undef C
+
+chanSs_t
+chanStrRATEa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanStrRATEc *c;
+  unsigned int s;
+  unsigned long r;
+  unsigned long b;
+  unsigned long (*k)(void *);
+
+  if (!v)
+    return (0);
+  *v = 0;
+  s = va_arg(l, unsigned int);
+  r = va_arg(l, unsigned long);
+  b = va_arg(l, unsigned long);
+  k = va_arg(l, unsigned long (*)(void *));
+  if (!a || !f || !w || !s || !r || !b)
+    return (0);
+  if (!(c = a(0, sizeof (*c))))
+    return (0);
+  if (!(c->q = a(0, s * sizeof (*c->q)))) {
+    f(c);
+    return (0);
+  }
+  if (!(c->m = chanStrTmrNew(a, f, fire, c))) {
+    f(c->q);
+    f(c);
+    return (0);
+  }
+  c->p = c->a = 0;
+  c->r = r;
+  c->b = b;
+  c->k = k;
+  c->s = s;
+  c->h = c->t = c->n = 0;
+  c->w = w;
+  c->x = x;
+  c->f = f;
+  c->d = u;
+  *d = chanStrRATEd;
+  *i = chanStrRATEi;
+  *v = c;
+  return (chanSsCanPut);
+}
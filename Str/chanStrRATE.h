@@ -0,0 +1,47 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANSTRRATE_H__
+#define __CHANSTRRATE_H__
+
+/* a bounded rate limiting FIFO Store (token bucket)
+ *  Gets are paced to rate per second, with a burst of up to burst after idle
+ *  cost returns the tokens an item takes (e.g. a chanBlb_t's l for bytes per second), if 0, an item takes 1
+ *  an item that costs more than burst is got when the bucket is full (the excess is paid after)
+ *  a shared timer thread (see chanStrTmr.h) wakes the Channel when tokens refill
+ */
+chanSs_t
+chanStrRATEa(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/* unsigned int size */
+/* unsigned long rate */
+/* unsigned long burst */
+/* unsigned long (*cost)(void *item) */
+);
+
+#endif /* __CHANSTRRATE_H__ */
@@ -0,0 +1,172 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "chan.h"
+#include "chanStrSEG.h"
+
+struct chanStrSEGs {
+  struct chanStrSEGs *n; /* next segment */
+  void *q[1];        /* the first of k items */
+};
+
+struct chanStrSEGc {
+  void *(*a)(void *, unsigned long); /* realloc routine */
+  void (*f)(void *); /* free routine */
+  void (*d)(void *); /* item deallocation routine */
+  struct chanStrSEGs *h; /* head segment */
+  struct chanStrSEGs *t; /* tail segment */
+  struct chanStrSEGs *x; /* spare segment */
+  unsigned int k;    /* segment size */
+  unsigned int s;    /* store max */
+  unsigned int n;    /* items */
+  unsigned int i;    /* head offset */
+  unsigned int j;    /* tail offset */
+};
+
+#define C ((struct chanStrSEGc *)c)
+
+static struct chanStrSEGs *
+seg(
+  void *c
+){
+  return (C->a(0, sizeof (struct chanStrSEGs) + (C->k - 1) * sizeof (void *)));
+}
+
+static void
+chanStrSEGd(
+  void *c
+ ,chanSs_t s
+){
+  struct chanStrSEGs *g;
+
+  if (!c)
+    return;
+  for (; C->n; --C->n) {
+    if (C->i == C->k) {
+      C->i = 0;
+      g = C->h->n;
+      C->f(C->h);
+      C->h = g;
+    }
+    if (C->d)
+      C->d(C->h->q[C->i]);
+    ++C->i;
+  }
+  for (; C->h; C->h = g) {
+    g = C->h->n;
+    C->f(C->h);
+  }
+  C->f(C->x);
+  C->f(c);
+  (void)s; /* not needed */
+}
+
+static chanSs_t
+chanStrSEGi(
+  void *c
+ ,chanSo_t o
+ ,chanSw_t w
+ ,void **v
+){
+  struct chanStrSEGs *g;
+  chanSs_t s;
+
+  if (!c)
+    return (0);
+  if (o == chanSoPut) {
+    if (C->j == C->k) {
+      C->t->n = C->x;
+      C->t = C->x;
+      C->t->n = 0;
+      C->x = 0;
+      C->j = 0;
+    }
+    C->t->q[C->j++] = *v;
+    ++C->n;
+  } else {
+    *v = C->h->q[C->i++];
+    if (!--C->n)
+      C->i = C->j = 0;
+    else if (C->i == C->k) {
+      g = C->h;
+      C->h = g->n;
+      C->i = 0;
+      if (C->x)
+        C->f(g);
+      else
+        C->x = g;
+    }
+  }
+  s = 0;
+  if (C->n < C->s
+   && (C->j < C->k || C->x || (C->x = seg(c))))
+    s |= chanSsCanPut;
+  if (C->n)
+    s |= chanSsCanGet;
+  return (s);
+  (void)w;
+}
+
+#undef C
+
+chanSs_t
+chanStrSEGa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanStrSEGc *c;
+  unsigned int s;
+  unsigned int k;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  s = va_arg(l, unsigned int);
+  k = va_arg(l, unsigned int);
+  if (!a || !f || !s || !k)
+    return (0);
+  if (!(c = a(0, sizeof (*c))))
+    return (0);
+  c->a = a;
+  c->k = k;
+  if (!(c->h = c->t = seg(c))) {
+    f(c);
+    return (0);
+  }
+  c->t->n = 0;
+  c->x = 0;
+  c->s = s;
+  c->n = c->i = c->j = 0;
+  c->f = f;
+  c->d = u;
+  *d = chanStrSEGd;
+  *i = chanStrSEGi;
+  *v = c;
+  return (chanSsCanPut);
+  (void)w; /* not needed */
+  (void)x; /* not needed */
+}
@@ -0,0 +1,219 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#include <pthread.h>
+#include "chanStrTmr.h"
+
+struct chanStrTmr {
+  void (*f)(void *); /* free routine */
+  void (*r)(void *); /* fire routine */
+  void *x;           /* fire closure */
+  struct chanStrTmr *p; /* previous armed */
+  struct chanStrTmr *n; /* next armed */
+  struct timespec a; /* armed time */
+  int s;             /* armed */
+  int b;             /* firing */
+};
+
+static pthread_mutex_t M = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t A;       /* armed list head changed */
+static pthread_cond_t B;       /* a fire returned */
+static struct chanStrTmr *H;   /* armed list, by time */
+static int R;                  /* thread running */
+
+static int
+cmp(
+  const struct timespec *a
+ ,const struct timespec *b
+){
+  if (a->tv_sec != b->tv_sec)
+    return (a->tv_sec < b->tv_sec ? -1 : 1);
+  if (a->tv_nsec != b->tv_nsec)
+    return (a->tv_nsec < b->tv_nsec ? -1 : 1);
+  return (0);
+}
+
+static void
+unarm(
+  struct chanStrTmr *t
+){
+  if (!t->s)
+    return;
+  if (t->p)
+    t->p->n = t->n;
+  else
+    H = t->n;
+  if (t->n)
+    t->n->p = t->p;
+  t->s = 0;
+}
+
+static void *
+tmrT(
+  void *v
+){
+  struct chanStrTmr *t;
+  struct timespec n;
+
+  pthread_mutex_lock(&M);
+  for (;;) {
+    if (!(t = H)) {
+      pthread_cond_wait(&A, &M);
+      continue;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &n);
+    if (cmp(&t->a, &n) > 0) {
+#ifdef HAVE_CONDATTR_SETCLOCK
+      n = t->a;
+#else
+      {
+        struct timespec r;
+
+        clock_gettime(CLOCK_REALTIME, &r);
+        r.tv_sec += t->a.tv_sec - n.tv_sec;
+        if ((r.tv_nsec += t->a.tv_nsec - n.tv_nsec) < 0) {
+          r.tv_nsec += 1000000000;
+          --r.tv_sec;
+        } else if (r.tv_nsec >= 1000000000) {
+          r.tv_nsec -= 1000000000;
+          ++r.tv_sec;
+        }
+        n = r;
+      }
+#endif
+      pthread_cond_timedwait(&A, &M, &n);
+      continue;
+    }
+    unarm(t);
+    t->b = 1;
+    pthread_mutex_unlock(&M);
+    t->r(t->x);
+    pthread_mutex_lock(&M);
+    t->b = 0;
+    pthread_cond_broadcast(&B);
+  }
+  pthread_mutex_unlock(&M);
+  return (v);
+}
+
+void *
+chanStrTmrNew(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*r)(void *)
+ ,void *x
+){
+  struct chanStrTmr *t;
+
+  if (!a || !f || !r
+   || !(t = a(0, sizeof (*t))))
+    return (0);
+  pthread_mutex_lock(&M);
+  if (!R) {
+    pthread_condattr_t c;
+    pthread_attr_t p;
+    pthread_t h;
+
+    if (pthread_condattr_init(&c))
+      goto error;
+#ifdef HAVE_CONDATTR_SETCLOCK
+    pthread_condattr_setclock(&c, CLOCK_MONOTONIC);
+#endif
+    if (pthread_cond_init(&A, &c)) {
+      pthread_condattr_destroy(&c);
+      goto error;
+    }
+    pthread_condattr_destroy(&c);
+    if (pthread_cond_init(&B, 0)) {
+      pthread_cond_destroy(&A);
+      goto error;
+    }
+    if (pthread_attr_init(&p)) {
+      pthread_cond_destroy(&B);
+      pthread_cond_destroy(&A);
+      goto error;
+    }
+    pthread_attr_setdetachstate(&p, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&h, &p, tmrT, 0)) {
+      pthread_attr_destroy(&p);
+      pthread_cond_destroy(&B);
+      pthread_cond_destroy(&A);
+      goto error;
+    }
+    pthread_attr_destroy(&p);
+    R = 1;
+  }
+  pthread_mutex_unlock(&M);
+  t->f = f;
+  t->r = r;
+  t->x = x;
+  t->p = t->n = 0;
+  t->s = t->b = 0;
+  return (t);
+error:
+  pthread_mutex_unlock(&M);
+  f(t);
+  return (0);
+}
+
+void
+chanStrTmrSet(
+  void *v
+ ,const struct timespec *a
+){
+  struct chanStrTmr *t;
+  struct chanStrTmr *p;
+
+  if (!(t = v))
+    return;
+  pthread_mutex_lock(&M);
+  unarm(t);
+  if (a) {
+    t->a = *a;
+    for (p = 0, t->n = H; t->n && cmp(&t->n->a, a) <= 0; p = t->n, t->n = t->n->n);
+    if ((t->p = p))
+      p->n = t;
+    else {
+      H = t;
+      pthread_cond_signal(&A);
+    }
+    if (t->n)
+      t->n->p = t;
+    t->s = 1;
+  }
+  pthread_mutex_unlock(&M);
+}
+
+void
+chanStrTmrDel(
+  void *v
+){
+  struct chanStrTmr *t;
+
+  if (!(t = v))
+    return;
+  pthread_mutex_lock(&M);
+  unarm(t);
+  while (t->b)
+    pthread_cond_wait(&B, &M);
+  pthread_mutex_unlock(&M);
+  t->f(t);
+}
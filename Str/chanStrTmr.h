@@ -0,0 +1,52 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHANSTRTMR_H__
+#define __CHANSTRTMR_H__
+
+/* a shared timer thread for Stores that wake (see wake in chan.h)
+ *  times are CLOCK_MONOTONIC
+ *  a timer fires once per chanStrTmrSet, fire is not called with any timer lock held
+ */
+
+/* return a new (unarmed) timer that calls fire(closure) (0 on failure) */
+void *
+chanStrTmrNew(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*fire)(void *closure)
+ ,void *closure
+);
+
+/* arm (or rearm) a timer to fire at a time, 0 disarms */
+void
+chanStrTmrSet(
+  void *timer
+ ,const struct timespec *at
+);
+
+/* disarm, wait for a fire in progress and deallocate a timer */
+/* calling with 0 is a harmless no-op */
+void
+chanStrTmrDel(
+  void *timer
+);
+
+#endif /* __CHANSTRTMR_H__ */
@@ -156,6 +156,8 @@ struct chan {
   unsigned int c;  /* open count */
   unsigned int l;  /* below chan bit flags */
   chanSs_t t;      /* store status */
+  void (*n)(void *); /* note function */
+  void *x;         /* note closure */
   pthread_mutex_t m;
 };
 
@@ -211,6 +213,12 @@ static const unsigned int chanSu = 0x80; /* is shutdown */
   c->l &= ~F;\
 } while (0)
 
+/* tell an event loop the Channel may have changed */
+#define NOTE() do {\
+  if (c->n)\
+    c->n(c->x);\
+} while (0)
+
 /* dequeue and wakeup "other" thread(s) */
 #define WAKE(F,V,W,B) do {\
   while (!(c->l & F) && W) {\
@@ -248,6 +256,7 @@ shut(
   if (c->l & chanSu)
     return;
   c->l |= chanSu;
+  NOTE();
   m = 0;
   WAKE(chanGe, g, 1, ;);
   WAKE(chanPe, p, 1, ;);
@@ -273,6 +282,8 @@ chanWake(
     pthread_mutex_unlock(&c->m);
     return (1);
   }
+  if (s & chanSsWake)
+    s = c->i(c->v, chanSoNop, c->l & (chanGe | chanPe), 0);
   if (!s)
     shut(c);
   else {
@@ -285,6 +296,7 @@ chanWake(
       c->t |= chanSsCanPut;
       WAKE(chanPe, p, c->t & chanSsCanPut, break;);
     }
+    NOTE();
   }
   pthread_mutex_unlock(&c->m);
   return (0);
@@ -319,6 +331,7 @@ error:
   c->i = 0;
   c->d = 0;
   c->s = s;
+  c->n = 0;
   if (a) {
     va_list l;
 
@@ -394,6 +407,7 @@ chanClose(
   ChanF(c->e);
   ChanF(c->u);
   ChanF(c->h);
+  c->i = 0; /* a late Store wake is a no-op */
   pthread_mutex_unlock(&c->m);
   if (c->d)
     c->d(c->v, c->t);
@@ -417,6 +431,20 @@ chanOpenCnt(
   return (r);
 }
 
+void
+chanNote(
+  chan_t *c
+ ,void (*n)(void *)
+ ,void *x
+){
+  if (!c)
+    return;
+  pthread_mutex_lock(&c->m);
+  c->n = n;
+  c->x = x;
+  pthread_mutex_unlock(&c->m);
+}
+
 chanOs_t
 chanOp(
   long w
@@ -497,6 +525,7 @@ get1:
           *((a + i)->v) = c->v;
           c->t = chanSsCanPut;
         }
+        NOTE();
         k = 0;
         WAKE(chanPe, p, c->t & chanSsCanPut, k=1;break;);
         if (!k && !(c->l & chanGe))
@@ -533,6 +562,7 @@ put1:
           c->v = *((a + i)->v);
           c->t = chanSsCanGet;
         }
+        NOTE();
         k = 0;
         WAKE(chanGe, g, c->t & chanSsCanGet, k=1;break;);
         if (!k && !(c->l & chanPe))
@@ -1212,6 +1242,7 @@ unlock1:
           *((a + i)->v) = c->v;
           c->t = chanSsCanPut;
         }
+        NOTE();
         k = 0;
         WAKE(chanPe, p, c->t & chanSsCanPut, k=1;break;);
         if (!k && !(c->l & chanGe)) {
@@ -1241,6 +1272,7 @@ get1:
           c->v = *((a + i)->v);
           c->t = chanSsCanGet;
         }
+        NOTE();
         k = 0;
         WAKE(chanGe, g, c->t & chanSsCanGet, k=1;break;);
         if (!k && !(c->l & chanPe)) {
@@ -1531,6 +1563,7 @@ unlock2:
             *((a + i)->v) = c->v;
             c->t = chanSsCanPut;
           }
+          NOTE();
           k = 0;
           WAKE(chanPe, p, c->t & chanSsCanPut, k=1;break;);
           if (!k && !(c->l & chanGe)) {
@@ -1565,6 +1598,7 @@ unlock2:
             c->v = *((a + i)->v);
             c->t = chanSsCanGet;
           }
+          NOTE();
           k = 0;
           WAKE(chanGe, g, c->t & chanSsCanGet, k=1;break;);
           if (!k && !(c->l & chanPe)) {
@@ -31,6 +31,7 @@
 typedef enum chanSs { /* bit map */
   chanSsCanPut = 1 /* not full */
  ,chanSsCanGet = 2 /* not empty */
+ ,chanSsWake   = 4 /* Store wakes (returned alone, neither Put nor Get till wake) */
 } chanSs_t;
 
 /* Channel Store deallocation
@@ -49,6 +50,7 @@ typedef void
 typedef enum chanSo {
   chanSoGet
  ,chanSoPut
+ ,chanSoNop /* only when a Store wakes with chanSsWake, no item, return state */
 } chanSo_t;
 
 /* Channel Store wait */
@@ -64,7 +66,7 @@ typedef enum chanSw { /* bit map */
  *  a pointer to a Store closure,
  *  the operation the Channel wants to perform on the Store
  *  indication of waiting Gets and Puts
- *  and a value pointer
+ *  and a value pointer (a value Store copies the item at the pointer instead)
  * Return the state of the Store as it relates to Get and Put.
  *  if zero, shutdown the channel
  */
@@ -86,6 +88,13 @@ typedef chanSs_t
  *  a wake function (update store state outside a store operation call)
  *  a wake closure
  *
+ * wake(wakeClosure, state):
+ *  zero shuts the Channel, else chanSsCanPut and chanSsCanGet are added to the Channel's state
+ *  with chanSsWake, state is instead what the implementation returns for chanSoNop (under the Channel's lock)
+ *  return non-zero if the Channel is shutdown or being deallocated
+ *  it must not be called from within an implementation call
+ *  a Store that wakes must not return from its deallocation while a wake call is in progress
+ *
  * provides:
  *  a Store deallocation function or zero
  *  a Store implementation function
@@ -174,6 +183,19 @@ chanOpenCnt(
   chan_t *chn
 );
 
+/* Channel note, for an event loop that can't block in chanOp
+ *  note(closure) is called, under the Channel's lock, after each Get and Put, Store wake and on chanShut
+ *  it must not operate on Channels, only record the event (e.g. write an eventfd) then retry non-blocking
+ *  a Channel has one note, zero removes it (no note is in progress when chanNote returns)
+ * Calling with 0 is a harmless no-op
+ */
+void
+chanNote(
+  chan_t *chn
+ ,void (*note)(void *closure)
+ ,void *closure
+);
+
 /* Channel operation */
 typedef enum chanOp {
   chanOpNop = 0 /* no operation, skip */
@@ -197,6 +219,7 @@ typedef enum chanOs {
  *   0 block
  *  -1 non-blocking
  * val is where to get/put an item or 0 for monitor
+ *  (with a value Store, val is the item itself, copied in on Put and out on Get)
  */
 chanOs_t
 chanOp(
@@ -0,0 +1,230 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHAN_HPP__
+#define __CHAN_HPP__
+
+/* a header only C++17 layer over chan.h
+ *
+ * Channel<T> holds one chanOpen of a Channel (copy does chanOpen, destruction does chanClose)
+ *  small trivially copyable T are stored inline, in a value FIFO Store (see chanStrFIFOva), without allocation
+ *  T * are stored as is, a Channel never owns them
+ *  std::unique_ptr<U> are moved through as U *, ownership leaves the caller only when a Put succeeds
+ *  any other T is moved into a heap box
+ * select() is chanOne and all() is chanAll over Channel<T>::getOp() and Channel<T>::putOp() operations
+ *
+ * Link with chan.o and chanStrFIFO.o.
+ */
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+extern "C" {
+#include "chan.h"
+#include "chanStrFIFO.h"
+}
+
+namespace chn {
+
+/* largest trivially copyable T stored inline */
+constexpr unsigned int inlineMax = 64;
+
+namespace detail {
+
+template<typename T> struct unique : std::false_type {};
+template<typename U> struct unique<std::unique_ptr<U>> : std::true_type { using type = U; };
+
+template<typename T>
+constexpr bool copied = std::is_pointer_v<T>
+                     || (std::is_trivially_copyable_v<T> && sizeof (T) <= inlineMax);
+
+}
+
+/* an operation for select() or all(), status is valid after */
+class Op {
+public:
+  Op(Op &&o) noexcept : c(o.c), o(o.o), p(o.p), r(o.r), x(o.x), f(o.f), s(o.s) { o.f = 0; }
+  Op(const Op &) = delete;
+  Op &operator=(const Op &) = delete;
+  ~Op() { done(0); }
+  chanOs_t status() const { return (s); }
+
+private:
+  template<typename> friend class Channel;
+  template<typename... O> friend struct Arr;
+
+  Op(chan_t *c, chanOp_t o, void *p, void *r, int x, void (*f)(Op &, int))
+   : c(c), o(o), p(p), r(r), x(x), f(f), s(chanOsNop) {}
+  void done(int d) { if (f) { f(*this, d); f = 0; } }
+
+  chan_t *c;               /* Channel */
+  chanOp_t o;              /* operation */
+  void *p;                 /* item pointer */
+  void *r;                 /* caller's item */
+  int x;                   /* the caller's item is the val */
+  void (*f)(Op &, int);    /* finish, with non-zero if done */
+  chanOs_t s;              /* status */
+};
+
+/* chanOne result, index is one more than the offset of the operation, 0 on error */
+struct One {
+  unsigned int index;
+  chanOs_t status;
+};
+
+template<typename... O>
+struct Arr {
+  static_assert((std::is_same_v<std::decay_t<O>, Op> && ...), "operations are Op");
+  Op *p[sizeof... (O)];
+  chanArr_t a[sizeof... (O)];
+
+  Arr(O &... o) : p{&o...} {
+    for (unsigned int i = 0; i < sizeof... (O); ++i) {
+      a[i].c = p[i]->c;
+      a[i].v = p[i]->x ? static_cast<void **>(p[i]->r) : &p[i]->p;
+      a[i].x = 0;
+      a[i].o = p[i]->o;
+      a[i].s = chanOsNop;
+    }
+  }
+  void done() {
+    for (unsigned int i = 0; i < sizeof... (O); ++i) {
+      p[i]->s = a[i].s;
+      p[i]->done(a[i].s == chanOsGet || a[i].s == chanOsPut);
+    }
+  }
+};
+
+/* chanOne over operations */
+template<typename... O>
+One
+select(
+  long nsTimeout
+ ,O &&... o
+){
+  Arr<O...> a(o...);
+  unsigned int i;
+
+  i = chanOne(nsTimeout, sizeof... (O), a.a);
+  for (unsigned int j = 0; j < sizeof... (O); ++j)
+    if (j + 1 != i)
+      a.a[j].s = chanOsNop;
+  a.done();
+  return (One{i, i ? a.a[i - 1].s : chanOsNop});
+}
+
+/* chanAll over operations */
+template<typename... O>
+chanAl_t
+all(
+  long nsTimeout
+ ,O &&... o
+){
+  Arr<O...> a(o...);
+  chanAl_t r;
+
+  r = chanAll(nsTimeout, sizeof... (O), a.a);
+  a.done();
+  return (r);
+}
+
+template<typename T>
+class Channel {
+public:
+  /* size 0 is the default single item Channel (inline items get a one item Store) */
+  explicit Channel(unsigned int size = 0) {
+    if constexpr (detail::copied<T> && !std::is_pointer_v<T>)
+      c = chanCreate(0, chanStrFIFOva, size ? size : 1U, static_cast<unsigned int>(sizeof (T)));
+    else if (size)
+      c = chanCreate(dealloc(), chanStrFIFOa, size);
+    else
+      c = chanCreate(dealloc(), 0);
+  }
+  Channel(const Channel &o) : c(chanOpen(o.c)) {}
+  Channel(Channel &&o) noexcept : c(o.c) { o.c = 0; }
+  Channel &operator=(Channel o) noexcept { std::swap(c, o.c); return (*this); }
+  ~Channel() { chanClose(c); }
+
+  explicit operator bool() const { return (c != 0); }
+  chan_t *native() const { return (c); }
+  void shut() { chanShut(c); }
+
+  /* nsTimeout as chanOp */
+  chanOs_t put(T &v, long nsTimeout = 0) { return (one(putOp(v), nsTimeout)); }
+  template<typename V = T, typename = std::enable_if_t<detail::copied<V>>>
+  chanOs_t put(const V &v, long nsTimeout = 0) { return (one(putOp(const_cast<V &>(v)), nsTimeout)); }
+  chanOs_t get(T &v, long nsTimeout = 0) { return (one(getOp(v), nsTimeout)); }
+
+  Op putOp(T &v) {
+    if constexpr (detail::copied<T>)
+      return (Op(c, chanOpPut, 0, &v, 1, 0));
+    else if constexpr (detail::unique<T>::value)
+      return (Op(c, chanOpPut, v.get(), &v, 0, [](Op &o, int d) {
+        if (d)
+          static_cast<T *>(o.r)->release();
+      }));
+    else
+      return (Op(c, chanOpPut, new T(std::move(v)), &v, 0, [](Op &o, int d) {
+        if (!d) {
+          *static_cast<T *>(o.r) = std::move(*static_cast<T *>(o.p));
+          delete static_cast<T *>(o.p);
+        }
+      }));
+  }
+  Op getOp(T &v) {
+    if constexpr (detail::copied<T>)
+      return (Op(c, chanOpGet, 0, &v, 1, 0));
+    else if constexpr (detail::unique<T>::value)
+      return (Op(c, chanOpGet, 0, &v, 0, [](Op &o, int d) {
+        if (d)
+          static_cast<T *>(o.r)->reset(static_cast<typename detail::unique<T>::type *>(o.p));
+      }));
+    else
+      return (Op(c, chanOpGet, 0, &v, 0, [](Op &o, int d) {
+        if (d) {
+          *static_cast<T *>(o.r) = std::move(*static_cast<T *>(o.p));
+          delete static_cast<T *>(o.p);
+        }
+      }));
+  }
+
+private:
+  static void (*dealloc())(void *) {
+    if constexpr (detail::copied<T>)
+      return (0);
+    else if constexpr (detail::unique<T>::value)
+      return ([](void *p) { delete static_cast<typename detail::unique<T>::type *>(p); });
+    else
+      return ([](void *p) { delete static_cast<T *>(p); });
+  }
+  static chanOs_t one(Op &&o, long nsTimeout) {
+    One r;
+
+    r = select(nsTimeout, o);
+    return (r.index ? r.status : chanOsNop);
+  }
+
+  chan_t *c;
+};
+
+}
+
+#endif /* __CHAN_HPP__ */
@@ -24,42 +24,262 @@
 #include <pthread.h>
 #include "chan.h"
 #include "chanBlb.h"
+#include "chanStrTmr.h"
 #include "sqlite3.h"
 #include "chanBlbStrSQL.h"
 
-struct chanBlbStrSQLc {
+struct chanBlbStrSQLc;
+
+/* a database, shared by its queues */
+struct chanBlbStrSQLb {
   void (*f)(void *);          /* infrastructure free routine */
-  void (*d)(void *);          /* blob delete routine */
-  void *(*n)(unsigned long);  /* blob new routine */
+  struct chanBlbStrSQLc *q;   /* queues */
+  void *m;                    /* timer */
+  pthread_mutex_t l;          /* single writer */
+  pthread_cond_t c;           /* queue wakes done */
+  unsigned long gi;           /* group window, ns */
+  unsigned int gk;            /* group items */
+  unsigned int go;            /* operations in transaction */
+  unsigned int r;             /* references */
+  int ar;                     /* timer armed */
+  int wg;                     /* waking queues */
+  int e;                      /* failed, queues shutdown */
   sqlite3 *b;                 /* connection */
   sqlite3_stmt *bgn;
   sqlite3_stmt *cmt;
   sqlite3_stmt *rlb;
+};
+
+struct chanBlbStrSQLc {
+  void (*f)(void *);          /* infrastructure free routine */
+  void (*d)(void *);          /* blob delete routine */
+  void *(*n)(unsigned long);  /* blob new routine */
+  int (*w)(void *, chanSs_t); /* wake routine */
+  void *x;                    /* wake closure */
+  struct chanBlbStrSQLb *b;   /* database */
+  struct chanBlbStrSQLc *nq;  /* next queue */
+  sqlite3_int64 g;            /* committed items */
+  unsigned int gp;            /* Puts in transaction */
+  int fl;                     /* full */
+  int wk;                     /* wake */
+  int wn;                     /* waking */
+  chanBlb_t **q;              /* read-ahead ring */
+  sqlite3_int64 hl;           /* limit */
+  sqlite3_int64 hh;           /* head */
+  unsigned int rk;            /* read-ahead */
+  unsigned int ri;            /* ring offset */
+  unsigned int rn;            /* ring items */
+  unsigned int rd;            /* got, not yet deleted */
   sqlite3_stmt *insB;
   sqlite3_stmt *updT;
   sqlite3_stmt *delB;
   sqlite3_stmt *updH;
   sqlite3_stmt *sel;
+  sqlite3_stmt *selN;
+  sqlite3_stmt *delN;
+  sqlite3_stmt *updN;
 };
 
+#define B ((struct chanBlbStrSQLb *)b)
+
+static void
+arm(
+  void *b
+ ,unsigned long n
+){
+  struct timespec a;
+
+  clock_gettime(CLOCK_MONOTONIC, &a);
+  a.tv_sec += n / 1000000000;
+  if ((a.tv_nsec += n % 1000000000) >= 1000000000) {
+    a.tv_nsec -= 1000000000;
+    ++a.tv_sec;
+  }
+  chanStrTmrSet(B->m, &a);
+  B->ar = 1;
+}
+
+/* commit a group, its Puts can then be got, return non-zero if another queue needs a wake */
+static int
+commit(
+  void *b
+ ,struct chanBlbStrSQLc *c
+){
+  struct chanBlbStrSQLc *q;
+  int k;
+
+  sqlite3_step(B->cmt), sqlite3_reset(B->cmt);
+  for (k = 0, q = B->q; q; q = q->nq)
+    if (q->gp) {
+      q->g += q->gp;
+      q->gp = 0;
+      if (q != c)
+        k = q->wk = 1;
+    }
+  B->go = 0;
+  return (k);
+}
+
+/* roll back and shutdown every queue */
+static void
+fail(
+  void *b
+){
+  struct chanBlbStrSQLc *q;
+
+  sqlite3_step(B->rlb), sqlite3_reset(B->rlb);
+  for (q = B->q; q; q = q->nq) {
+    q->gp = q->rd = 0;
+    q->wk = 1;
+  }
+  B->go = 0;
+  B->e = 1;
+  if (B->m)
+    arm(b, 0);
+}
+
+static void
+fire(
+  void *b
+){
+  struct chanBlbStrSQLc *q;
+
+  pthread_mutex_lock(&B->l);
+  B->ar = 0;
+  if (B->go)
+    commit(b, 0);
+  for (q = B->q; q; q = q->nq) {
+    q->wn = q->wk;
+    q->wk = 0;
+  }
+  B->wg = 1;
+  pthread_mutex_unlock(&B->l);
+  /* queues aren't added or removed while waking */
+  for (q = B->q; q; q = q->nq)
+    if (q->wn)
+      q->w(q->x, chanSsWake);
+  pthread_mutex_lock(&B->l);
+  B->wg = 0;
+  pthread_cond_broadcast(&B->c);
+  pthread_mutex_unlock(&B->l);
+}
+
+static void
+release(
+  void *b
+){
+  unsigned int r;
+
+  pthread_mutex_lock(&B->l);
+  r = --B->r;
+  pthread_mutex_unlock(&B->l);
+  if (r)
+    return;
+  chanStrTmrDel(B->m);
+  sqlite3_finalize(B->bgn);
+  sqlite3_finalize(B->cmt);
+  sqlite3_finalize(B->rlb);
+  sqlite3_close(B->b);
+  pthread_cond_destroy(&B->c);
+  pthread_mutex_destroy(&B->l);
+  B->f(b);
+}
+
+#undef B
+
 #define C ((struct chanBlbStrSQLc *)c)
 
+/* delete the rows got from the read-ahead ring, return 0 on failure */
+static int
+flush(
+  void *c
+){
+  sqlite3_int64 e;
+
+  if (!C->rd)
+    return (1);
+  e = C->hh + C->rd - 1;
+  sqlite3_bind_int64(C->delN, 1, C->hh);
+  sqlite3_bind_int64(C->delN, 2, e > C->hl ? C->hl : e);
+  sqlite3_bind_int64(C->delN, 3, e > C->hl ? e - C->hl : 0);
+  C->hh = e % C->hl + 1;
+  sqlite3_bind_int64(C->updN, 1, C->hh);
+  if (sqlite3_step(C->delN) != SQLITE_DONE
+   || sqlite3_step(C->updN) != SQLITE_DONE) {
+    sqlite3_reset(C->delN);
+    sqlite3_reset(C->updN);
+    return (0);
+  }
+  sqlite3_reset(C->delN);
+  sqlite3_reset(C->updN);
+  C->rd = 0;
+  C->fl = 0;
+  return (1);
+}
+
+/* read ahead up to rk committed rows into the ring, return 0 on failure */
+static int
+fill(
+  void *c
+){
+  const void *t;
+  int i;
+  int j;
+
+  sqlite3_bind_int64(C->selN, 1, C->hh);
+  sqlite3_bind_int64(C->selN, 2, C->g < C->rk ? C->g : C->rk);
+  C->ri = 0;
+  while ((j = sqlite3_step(C->selN)) == SQLITE_ROW) {
+    t = sqlite3_column_blob(C->selN, 0);
+    if ((i = sqlite3_column_bytes(C->selN, 0)) < 0
+     || !(C->q[C->rn] = C->n(chanBlb_tSize(i))))
+      break;
+    C->q[C->rn]->l = i;
+    memcpy(C->q[C->rn]->b, t, i);
+    ++C->rn;
+  }
+  sqlite3_reset(C->selN);
+  return (j == SQLITE_DONE && C->rn);
+}
+
 static void
 chanBlbStrSQLd(
   void *c
  ,chanSs_t s
 ){
+  struct chanBlbStrSQLc **q;
+
   if (!c)
     return;
-  sqlite3_finalize(C->bgn);
-  sqlite3_finalize(C->cmt);
-  sqlite3_finalize(C->rlb);
+  pthread_mutex_lock(&C->b->l);
+  while (C->b->wg)
+    pthread_cond_wait(&C->b->c, &C->b->l);
+  if (C->rd && !C->b->e) {
+    if (!C->b->go)
+      sqlite3_step(C->b->bgn), sqlite3_reset(C->b->bgn);
+    ++C->b->go;
+    flush(c);
+  }
+  if (C->b->go && !C->b->e
+   && commit(C->b, c) && C->b->m)
+    arm(C->b, 0);
+  for (q = &C->b->q; *q != c; q = &(*q)->nq);
+  *q = C->nq;
+  pthread_mutex_unlock(&C->b->l);
   sqlite3_finalize(C->insB);
   sqlite3_finalize(C->updT);
   sqlite3_finalize(C->delB);
   sqlite3_finalize(C->updH);
   sqlite3_finalize(C->sel);
-  sqlite3_close(C->b);
+  sqlite3_finalize(C->selN);
+  sqlite3_finalize(C->delN);
+  sqlite3_finalize(C->updN);
+  if (C->q) {
+    for (; C->rn; --C->rn, ++C->ri)
+      C->d(C->q[C->ri]);
+    C->f(C->q);
+  }
+  release(C->b);
   C->f(c);
   return;
   (void)s; /* leaving blobs in store */
@@ -75,11 +295,22 @@ chanBlbStrSQLi(
  ,void **v
 ){
   const void *t;
+  chanSs_t s;
   int i;
 
   if (!c)
     return (0);
-  sqlite3_step(C->bgn), sqlite3_reset(C->bgn);
+  pthread_mutex_lock(&C->b->l);
+  if (C->b->e)
+    goto sht;
+  if (o == chanSoNop) {
+    if (C->b->go
+     && commit(C->b, c) && C->b->m)
+      arm(C->b, 0);
+    goto ret;
+  }
+  if (!C->b->go)
+    sqlite3_step(C->b->bgn), sqlite3_reset(C->b->bgn);
   if (o == chanSoPut) {
     sqlite3_bind_blob(C->insB, 1, (*V)->b, (*V)->l, SQLITE_STATIC);
     if (sqlite3_step(C->insB) != SQLITE_DONE)
@@ -88,11 +319,17 @@ chanBlbStrSQLi(
     C->d(*v);
     if (sqlite3_step(C->updT) != SQLITE_ROW)
       goto err;
-    i = sqlite3_column_int(C->updT, 0);
+    C->fl = sqlite3_column_int(C->updT, 0);
     sqlite3_reset(C->updT);
-    sqlite3_step(C->cmt), sqlite3_reset(C->cmt);
-    if (i)
-      return (chanSsCanGet);
+    ++C->gp;
+  } else if (C->q) {
+    if (!C->rn
+     && (!flush(c) || !fill(c)))
+      goto err;
+    *v = C->q[C->ri++];
+    --C->rn;
+    ++C->rd;
+    --C->g;
   } else {
     if (sqlite3_step(C->delB) != SQLITE_ROW
      || ((t = sqlite3_column_blob(C->delB, 0)), (i = sqlite3_column_bytes(C->delB, 0))) < 0
@@ -104,29 +341,65 @@ chanBlbStrSQLi(
     sqlite3_reset(C->delB);
     if (sqlite3_step(C->updH) != SQLITE_ROW)
       goto err;
-    i = sqlite3_column_int(C->updH, 0);
     sqlite3_reset(C->updH);
-    sqlite3_step(C->cmt), sqlite3_reset(C->cmt);
-    if (i)
-      return (chanSsCanPut);
+    C->fl = 0;
+    --C->g;
   }
-  return (chanSsCanGet | chanSsCanPut);
+  /* rows got from the ring hold their places till deleted */
+  if (C->fl && C->rd && !flush(c))
+    goto err;
+  /* a full Store of uncommitted Puts can't wait for the window */
+  if (++C->b->go >= C->b->gk || (C->fl && !C->g)) {
+    if (commit(C->b, c) && C->b->m)
+      arm(C->b, 0);
+  } else if (!C->b->ar)
+    arm(C->b, C->b->gi);
+ret:
+  C->wk = 0;
+  s = 0;
+  if (!C->fl)
+    s |= chanSsCanPut;
+  if (C->g)
+    s |= chanSsCanGet;
+  pthread_mutex_unlock(&C->b->l);
+  return (s);
 err:
   sqlite3_reset(C->insB);
   sqlite3_reset(C->updT);
   sqlite3_reset(C->delB);
   sqlite3_reset(C->updH);
-  sqlite3_step(C->rlb), sqlite3_reset(C->rlb);
+  fail(C->b);
+sht:
+  pthread_mutex_unlock(&C->b->l);
   return (0);
   (void)w; /* not concerned with latency */
 }
 
 #undef V
 
-#undef C
+static int
+prepare(
+  sqlite3 *b
+ ,sqlite3_stmt **s
+ ,const char *f
+ ,...
+){
+  va_list l;
+  char *z;
+  int i;
 
-chanSs_t
-chanBlbStrSQLa(
+  va_start(l, f);
+  z = sqlite3_vmprintf(f, l);
+  va_end(l);
+  if (!z)
+    return (SQLITE_NOMEM);
+  i = sqlite3_prepare_v3(b, z, -1, SQLITE_PREPARE_PERSISTENT, s, 0);
+  sqlite3_free(z);
+  return (i);
+}
+
+static chanSs_t
+queue(
   void *(*a)(void *, unsigned long)
  ,void (*f)(void *)
  ,void (*u)(void *)
@@ -135,7 +408,138 @@ chanBlbStrSQLa(
  ,chanSd_t *d
  ,chanSi_t *i
  ,void **v
- ,va_list l
+ ,void *(*n)(unsigned long)
+ ,struct chanBlbStrSQLb *b
+ ,sqlite3_int64 q
+ ,sqlite3_int64 z
+ ,unsigned int r
+){
+  struct chanBlbStrSQLc *c;
+  char *t;
+  char *e;
+
+  if (!(c = a(0, sizeof (*c))))
+    return (0);
+  memset(c, 0, sizeof (*c));
+  if (r > 1 && !(c->q = a(0, r * sizeof (*c->q)))) {
+    f(c);
+    return (0);
+  }
+  C->f = f;
+  C->d = u;
+  C->n = n;
+  C->w = w;
+  C->x = x;
+  C->b = b;
+  C->rk = r;
+  /* queue 1 is table "B" (a database of one queue), else "B" followed by the queue */
+  if (q == 1)
+    t = sqlite3_mprintf("B");
+  else
+    t = sqlite3_mprintf("B%lld", q);
+  if (!t) {
+    f(C->q);
+    f(c);
+    return (0);
+  }
+  pthread_mutex_lock(&b->l);
+  while (b->wg)
+    pthread_cond_wait(&b->c, &b->l);
+  if (b->e)
+    goto shut;
+  /* a queue is created in a transaction of its own */
+  if (b->go
+   && commit(b, 0) && b->m)
+    arm(b, 0);
+  sqlite3_step(b->bgn), sqlite3_reset(b->bgn);
+  if (!(e = sqlite3_mprintf(
+     "CREATE TABLE IF NOT EXISTS \"%w\"("
+     "\"i\" INTEGER PRIMARY KEY"
+     ",\"b\" BLOB"
+     ");"
+     "INSERT OR IGNORE INTO \"H\" VALUES (%lld,%lld,1,1);" /* largest signed 64bit = 9223372036854775807 */
+    ,t, q, z)))
+    goto err;
+  if (sqlite3_exec(b->b, e, 0, 0, 0)) {
+    sqlite3_free(e);
+    goto err;
+  }
+  sqlite3_free(e);
+  if (prepare(b->b, &C->insB
+    ,"INSERT INTO \"%w\" VALUES((SELECT \"t\" FROM \"H\" WHERE \"i\"=%lld),?1)"
+    ,t, q)
+   || prepare(b->b, &C->updT
+    ,"UPDATE \"H\" SET \"t\"=CASE WHEN \"t\"=\"l\" THEN 1 ELSE \"t\"+1 END WHERE \"i\"=%lld RETURNING \"t\"=\"h\""
+    ,q)
+   || prepare(b->b, &C->delB
+    ,"DELETE FROM \"%w\" WHERE \"i\"=(SELECT \"h\" FROM \"H\" WHERE \"i\"=%lld) RETURNING \"b\""
+    ,t, q)
+   || prepare(b->b, &C->updH
+    ,"UPDATE \"H\" SET \"h\"=CASE WHEN \"h\"=\"l\" THEN 1 ELSE \"h\"+1 END WHERE \"i\"=%lld RETURNING \"h\"=\"t\""
+    ,q)
+   || prepare(b->b, &C->sel
+    ,"WITH \"T\"(\"c\")AS(SELECT COUNT(*) FROM \"%w\")SELECT \"T\".\"c\",\"T\".\"c\">=\"H\".\"l\",\"H\".\"l\",\"H\".\"h\" FROM \"H\",\"T\" WHERE \"H\".\"i\"=%lld"
+    ,t, q)
+   /* the rows from the head, then (wrapped) from the first */
+   || prepare(b->b, &C->selN
+    ,"SELECT * FROM(SELECT \"b\" FROM \"%w\" WHERE \"i\">=?1 ORDER BY \"i\" LIMIT ?2)"
+     "UNION ALL SELECT * FROM(SELECT \"b\" FROM \"%w\" WHERE \"i\"<?1 ORDER BY \"i\" LIMIT ?2)LIMIT ?2"
+    ,t, t)
+   || prepare(b->b, &C->delN
+    ,"DELETE FROM \"%w\" WHERE \"i\" BETWEEN ?1 AND ?2 OR \"i\"<=?3"
+    ,t)
+   || prepare(b->b, &C->updN
+    ,"UPDATE \"H\" SET \"h\"=?1 WHERE \"i\"=%lld"
+    ,q)
+  )
+    goto err;
+  if (sqlite3_step(C->sel) != SQLITE_ROW)
+    goto err;
+  C->g = sqlite3_column_int64(C->sel, 0);  /* items */
+  C->fl = sqlite3_column_int(C->sel, 1);   /* full */
+  C->hl = sqlite3_column_int64(C->sel, 2); /* limit */
+  C->hh = sqlite3_column_int64(C->sel, 3); /* head */
+  sqlite3_reset(C->sel);
+  sqlite3_step(b->cmt), sqlite3_reset(b->cmt);
+  C->nq = b->q;
+  b->q = c;
+  ++b->r;
+  pthread_mutex_unlock(&b->l);
+  sqlite3_free(t);
+  *d = chanBlbStrSQLd;
+  *i = chanBlbStrSQLi;
+  *v = c;
+  return (chanBlbStrSQLi(c, chanSoNop, 0, 0));
+err:
+fprintf(stderr, "SQLite error %s\n", sqlite3_errmsg(b->b));
+  sqlite3_step(b->rlb), sqlite3_reset(b->rlb);
+shut:
+  pthread_mutex_unlock(&b->l);
+  sqlite3_finalize(C->insB);
+  sqlite3_finalize(C->updT);
+  sqlite3_finalize(C->delB);
+  sqlite3_finalize(C->updH);
+  sqlite3_finalize(C->sel);
+  sqlite3_finalize(C->selN);
+  sqlite3_finalize(C->delN);
+  sqlite3_finalize(C->updN);
+  sqlite3_free(t);
+  f(C->q);
+  f(c);
+  return (0);
+}
+
+#undef C
+
+void *
+chanBlbStrSQLopen(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,const char *p
+ ,unsigned int o
+ ,unsigned int y
+ ,unsigned int k
+ ,unsigned long g
 ){
   static const char *jnl[] = {
     "PRAGMA journal_mode=DELETE;"
@@ -149,110 +553,201 @@ chanBlbStrSQLa(
    ,"PRAGMA synchronous=FULL;"
    ,"PRAGMA synchronous=EXTRA;"
   };
-  struct chanBlbStrSQLc *c;
-  void *(*n)(unsigned long);
-  const char *p;
-  unsigned int o;
-  unsigned int y;
-  sqlite3_int64 z;
-  int s;
+  struct chanBlbStrSQLb *b;
 
-  if (!v)
-    return (0);
-  *v = 0;
-  n = va_arg(l, void *(*)(unsigned long)); /* blob new routine */
-  p = va_arg(l, const char *);             /* sqlite path name */
-  o = va_arg(l, unsigned int);             /* journal_mode */
-  y = va_arg(l, unsigned int);             /* synchronous */
-  z = va_arg(l, sqlite3_int64);            /* size to allow */
-  if (!a || !f || !n || !p
+  if (!a || !f || !p
    || o >= sizeof (jnl) / sizeof (jnl[0])
    || y >= sizeof (syn) / sizeof (syn[0])
-   || !z)
+   || (k > 1 && !g))
     return (0);
-  if (!(c = a(0, sizeof (*c))))
+  if (!(b = a(0, sizeof (*b))))
     return (0);
-  memset(c, 0, sizeof (*c));
-  c->f = f;
-  c->d = u;
-  c->n = n;
-  if (sqlite3_open_v2(p, &c->b, SQLITE_OPEN_READWRITE, 0)) {
-    sqlite3_close(c->b);
-    if (sqlite3_open_v2(p, &c->b, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, 0))
+  memset(b, 0, sizeof (*b));
+  if (pthread_mutex_init(&b->l, 0)) {
+    f(b);
+    return (0);
+  }
+  if (pthread_cond_init(&b->c, 0)) {
+    pthread_mutex_destroy(&b->l);
+    f(b);
+    return (0);
+  }
+  b->f = f;
+  b->gk = k;
+  b->gi = g;
+  b->r = 1;
+  if (k > 1 && !(b->m = chanStrTmrNew(a, f, fire, b)))
+    goto err;
+  if (sqlite3_open_v2(p, &b->b, SQLITE_OPEN_READWRITE, 0)) {
+    sqlite3_close(b->b);
+    if (sqlite3_open_v2(p, &b->b, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, 0))
       goto err;
   }
   /* SQLite doesn't provide inter-process notification of file updates, so use an EXCLUSIVE locking guard */
-  if (sqlite3_exec(c->b, "PRAGMA locking_mode=EXCLUSIVE;", 0, 0, 0)
-   || sqlite3_exec(c->b, jnl[o], 0, 0, 0)
-   || sqlite3_exec(c->b, syn[y], 0, 0, 0))
+  if (sqlite3_exec(b->b, "PRAGMA locking_mode=EXCLUSIVE;", 0, 0, 0)
+   || sqlite3_exec(b->b, jnl[o], 0, 0, 0)
+   || sqlite3_exec(b->b, syn[y], 0, 0, 0))
     goto err;
-  if (sqlite3_exec(c->b
-   ,"BEGIN IMMEDIATE;"
-    "CREATE TABLE IF NOT EXISTS \"H\"("
-    "\"i\" INTEGER PRIMARY KEY"
+  if (sqlite3_exec(b->b
+   ,"CREATE TABLE IF NOT EXISTS \"H\"("
+    "\"i\" INTEGER PRIMARY KEY" /* queue */
     ",\"l\" INTEGER" /* limit */
     ",\"h\" INTEGER" /* head */
     ",\"t\" INTEGER" /* tail */
     ");"
-    "CREATE TABLE IF NOT EXISTS \"B\"("
-    "\"i\" INTEGER PRIMARY KEY"
-    ",\"b\" BLOB"
-    ");"
    ,0, 0, 0))
     goto err;
-  if (sqlite3_prepare_v2(c->b
-   ,"INSERT OR IGNORE INTO \"H\" VALUES (1,?1,1,1);"
-   ,-1, &c->bgn, 0))
-    goto err;
-  sqlite3_bind_int64(c->bgn, 1, z); /* largest signed 64bit = 9223372036854775807 */
-  if (sqlite3_step(c->bgn) != SQLITE_DONE)
-    goto err;
-  sqlite3_finalize(c->bgn);
-  if (sqlite3_prepare_v3(c->b
+  if (sqlite3_prepare_v3(b->b
     ,"BEGIN IMMEDIATE"
-    ,-1, SQLITE_PREPARE_PERSISTENT, &c->bgn, 0)
-   || sqlite3_prepare_v3(c->b
+    ,-1, SQLITE_PREPARE_PERSISTENT, &b->bgn, 0)
+   || sqlite3_prepare_v3(b->b
     ,"COMMIT"
-    ,-1, SQLITE_PREPARE_PERSISTENT, &c->cmt, 0)
-   || sqlite3_prepare_v3(c->b
+    ,-1, SQLITE_PREPARE_PERSISTENT, &b->cmt, 0)
+   || sqlite3_prepare_v3(b->b
     ,"ROLLBACK"
-    ,-1, SQLITE_PREPARE_PERSISTENT, &c->rlb, 0)
-   || sqlite3_prepare_v3(c->b
-    ,"INSERT INTO \"B\" VALUES((SELECT \"t\" FROM \"H\" WHERE \"i\"=1),?1)"
-    ,-1, SQLITE_PREPARE_PERSISTENT, &c->insB, 0)
-   || sqlite3_prepare_v3(c->b
-    ,"UPDATE \"H\" SET \"t\"=CASE WHEN \"t\"=\"l\" THEN 1 ELSE \"t\"+1 END WHERE \"i\"=1 RETURNING \"t\"=\"h\""
-    ,-1, SQLITE_PREPARE_PERSISTENT, &c->updT, 0)
-   || sqlite3_prepare_v3(c->b
-    ,"DELETE FROM \"B\" WHERE \"i\"=(SELECT \"h\" FROM \"H\" WHERE \"i\"=1) RETURNING \"b\""
-    ,-1, SQLITE_PREPARE_PERSISTENT, &c->delB, 0)
-   || sqlite3_prepare_v3(c->b
-    ,"UPDATE \"H\" SET \"h\"=CASE WHEN \"h\"=\"l\" THEN 1 ELSE \"h\"+1 END WHERE \"i\"=1 RETURNING \"h\"=\"t\""
-    ,-1, SQLITE_PREPARE_PERSISTENT, &c->updH, 0)
-   || sqlite3_prepare_v3(c->b
-    ,"WITH \"T\"(\"c\")AS(SELECT COUNT(*) FROM \"B\")SELECT \"T\".\"c\">0,\"T\".\"c\"<\"H\".\"l\" FROM \"H\",\"T\" WHERE \"H\".\"i\"=1"
-    ,-1, SQLITE_PREPARE_PERSISTENT, &c->sel, 0)
+    ,-1, SQLITE_PREPARE_PERSISTENT, &b->rlb, 0)
   )
     goto err;
-  if (sqlite3_step(c->sel) != SQLITE_ROW)
-    goto err;
-  s = 0;
-  if (sqlite3_column_int(c->sel, 0)) /* not empty */
-    s |= chanSsCanGet;
-  if (sqlite3_column_int(c->sel, 1)) /* not full */
-    s |= chanSsCanPut;
-  sqlite3_reset(c->sel);
-  sqlite3_step(c->cmt), sqlite3_reset(c->cmt);
-  *d = chanBlbStrSQLd;
-  *i = chanBlbStrSQLi;
-  *v = c;
-  return (s);
+  return (b);
 err:
-fprintf(stderr, "SQLite error %s\n", sqlite3_errmsg(c->b));
-  sqlite3_step(c->rlb), sqlite3_reset(c->rlb);
-  chanBlbStrSQLd(c, 0);
+fprintf(stderr, "SQLite error %s\n", sqlite3_errmsg(b->b));
+  release(b);
   return (0);
 /* locking_mode=EXCLUSIVE unused */
-  (void)w; /* wake callback */
-  (void)x; /* wake callback closure */
+}
+
+void
+chanBlbStrSQLclose(
+  void *b
+){
+  if (b)
+    release(b);
+}
+
+chanSs_t
+chanBlbStrSQLqa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  struct chanBlbStrSQLb *b;
+  void *(*n)(unsigned long);
+  sqlite3_int64 q;
+  sqlite3_int64 z;
+  unsigned int r;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  n = va_arg(l, void *(*)(unsigned long)); /* blob new routine */
+  b = va_arg(l, struct chanBlbStrSQLb *);  /* database */
+  q = va_arg(l, sqlite3_int64);            /* queue */
+  z = va_arg(l, sqlite3_int64);            /* size to allow */
+  r = va_arg(l, unsigned int);             /* read-ahead */
+  if (!a || !f || !n || !b || q < 1 || z < 1
+   || (b->gk > 1 && !w))
+    return (0);
+  return (queue(a, f, u, w, x, d, i, v, n, b, q, z, r));
+}
+
+/* a queue in a database of its own */
+static chanSs_t
+own(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,void *(*n)(unsigned long)
+ ,const char *p
+ ,unsigned int o
+ ,unsigned int y
+ ,sqlite3_int64 z
+ ,unsigned int k
+ ,unsigned long g
+ ,unsigned int r
+){
+  void *b;
+  chanSs_t s;
+
+  if (!a || !f || !n || z < 1
+   || (k > 1 && !w)
+   || !(b = chanBlbStrSQLopen(a, f, p, o, y, k, g)))
+    return (0);
+  s = queue(a, f, u, w, x, d, i, v, n, b, 1, z, r);
+  release(b);
+  return (s);
+}
+
+chanSs_t
+chanBlbStrSQLa(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  void *(*n)(unsigned long);
+  const char *p;
+  unsigned int o;
+  unsigned int y;
+  sqlite3_int64 z;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  n = va_arg(l, void *(*)(unsigned long)); /* blob new routine */
+  p = va_arg(l, const char *);             /* sqlite path name */
+  o = va_arg(l, unsigned int);             /* journal_mode */
+  y = va_arg(l, unsigned int);             /* synchronous */
+  z = va_arg(l, sqlite3_int64);            /* size to allow */
+  return (own(a, f, u, w, x, d, i, v, n, p, o, y, z, 0, 0, 0));
+}
+
+chanSs_t
+chanBlbStrSQLga(
+  void *(*a)(void *, unsigned long)
+ ,void (*f)(void *)
+ ,void (*u)(void *)
+ ,int (*w)(void *, chanSs_t)
+ ,void *x
+ ,chanSd_t *d
+ ,chanSi_t *i
+ ,void **v
+ ,va_list l
+){
+  void *(*n)(unsigned long);
+  const char *p;
+  unsigned int o;
+  unsigned int y;
+  sqlite3_int64 z;
+  unsigned int k;
+  unsigned long g;
+  unsigned int r;
+
+  if (!v)
+    return (0);
+  *v = 0;
+  n = va_arg(l, void *(*)(unsigned long)); /* blob new routine */
+  p = va_arg(l, const char *);             /* sqlite path name */
+  o = va_arg(l, unsigned int);             /* journal_mode */
+  y = va_arg(l, unsigned int);             /* synchronous */
+  z = va_arg(l, sqlite3_int64);            /* size to allow */
+  k = va_arg(l, unsigned int);             /* group items */
+  g = va_arg(l, unsigned long);            /* group window */
+  r = va_arg(l, unsigned int);             /* read-ahead */
+  return (own(a, f, u, w, x, d, i, v, n, p, o, y, z, k, g, r));
 }
@@ -21,6 +21,58 @@
 #ifndef __CHANBLBSTRSQL_H__
 #define __CHANBLBSTRSQL_H__
 
+/* a maximum sized persistent FIFO Store of chanBlb_t items in an SQLite database
+ *  a database can be shared by many Stores (queues), its Puts and Gets from all queues are done by one writer
+ *  Puts and Gets are grouped, up to group operations share a transaction (0 or 1, a transaction each)
+ *  a group is committed when full, when the Store is full, or groupNs after it began (using the Store wake)
+ *  a Put can be got only after its group is committed (durable, per synchronous)
+ *  with a readAhead of more than one, Gets are served from a ring filled by one statement,
+ *   rows got are deleted by one statement when the ring is refilled, the Store is full or deallocated
+ *   (after a crash, rows got but not yet deleted are got again)
+ */
+/* open a database (journal_mode, synchronous, group and groupNs as chanBlbStrSQLga) to share, 0 on failure */
+void *
+chanBlbStrSQLopen(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,const char *path
+ ,unsigned int journal_mode
+ ,unsigned int synchronous
+ ,unsigned int group
+ ,unsigned long groupNs
+);
+
+/* release a database, it is closed after its last queue is deallocated */
+/* calling with 0 is a harmless no-op */
+void
+chanBlbStrSQLclose(
+  void *database
+);
+
+/* a queue in a shared database
+ *  a group transaction is shared by all queues, a queue whose Puts another queue commits is woken by the timer
+ *  queue 1 is the queue of chanBlbStrSQLa and chanBlbStrSQLga
+ *  an SQLite error rolls back the transaction and shuts down every queue of the database
+ */
+chanSs_t
+chanBlbStrSQLqa(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/*  void *(*allocBlb)(unsigned long) */
+/*  void *database */
+/*  sqlite3_int64 queue (1 or more) */
+/*  sqlite3_int64 size */
+/*  unsigned int readAhead */
+);
+
+/* a Store in a database of its own, a transaction per Put and Get */
 chanSs_t
 chanBlbStrSQLa(
   void *(*realloc)(void *, unsigned long)
@@ -36,7 +88,29 @@ chanBlbStrSQLa(
 /*  const char *path */
 /*  unsigned int journal_mode */
 /*  unsigned int synchronous */
-/*  unsigned int size */
+/*  sqlite3_int64 size */
+);
+
+/* a Store in a database of its own, with group commit and read-ahead */
+chanSs_t
+chanBlbStrSQLga(
+  void *(*realloc)(void *, unsigned long)
+ ,void (*free)(void *)
+ ,void (*dequeue)(void *)
+ ,int (*wake)(void *, chanSs_t)
+ ,void *wakeClosure
+ ,chanSd_t *deallocation
+ ,chanSi_t *implementation
+ ,void **storeClosure
+ ,va_list list
+/*  void *(*allocBlb)(unsigned long) */
+/*  const char *path */
+/*  unsigned int journal_mode */
+/*  unsigned int synchronous */
+/*  sqlite3_int64 size */
+/*  unsigned int group */
+/*  unsigned long groupNs */
+/*  unsigned int readAhead */
 );
 
 #endif /* __CHANBLBSTRSQL_H__ */
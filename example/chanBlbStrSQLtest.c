@@ -35,16 +35,18 @@
  *
  * link it all together with channel objects like:
  *
- *  cc -o chanBlbStrSQLtest chanBlbStrSQLtest.o chanBlbStrSQL.o sqlite3.o chanBlb.o chanStrFIFO.o chan.o -lpthread
+ *  cc -o chanBlbStrSQLtest chanBlbStrSQLtest.o chanBlbStrSQL.o sqlite3.o chanBlb.o chanStrFIFO.o chanStrTmr.o chan.o -lpthread
  *
  * Usage:
- *  ./chanBlbStrSQLtest file journal(0:DELETE,1:TRUNCATE,2:PERSIST,3:WAL) synchronous(0:OFF,1:NORMAL,2:FULL,3:EXTRA) messages g|p|b
+ *  ./chanBlbStrSQLtest file journal(0:DELETE,1:TRUNCATE,2:PERSIST,3:WAL) synchronous(0:OFF,1:NORMAL,2:FULL,3:EXTRA) messages g|p|b [group groupUs [readAhead]]
  *
  *  (file for SQLite, :memory: is fast but much more expensive than chanStrFIFO, which is used if file is zero length)
  *  (SQLite PRAGMA journal_mode, 0=DELETE, 1=TRUNCATE, 2=PERSIST, 3=WAL)
  *  (SQLite PRAGMA synchronous, 0=OFF, 1=NORMAL, 2=FULL, 3=EXTRA)
  *  (messages limit, only significant on initial create)
  *  (g:get or p:put or b:both get and put)
+ *  (optional group commit, operations in a transaction and microseconds a transaction stays open)
+ *  (optional read-ahead, rows read in one statement for Gets)
  *
  * run it like:
  *
@@ -145,11 +147,17 @@ main(
   ,arg_messages
   ,arg_operation
   ,arg_NUM
+  ,arg_group = arg_NUM
+  ,arg_groupUs
+  ,arg_readAhead
   };
   chan_t *c;
   pthread_t in;
   pthread_t out;
   sqlite3_int64 z;
+  unsigned int k;
+  unsigned long u;
+  unsigned int r;
   int j;
   int s;
 
@@ -164,13 +172,19 @@ main(
                     " journal(0:DELETE,1:TRUNCATE,2:PERSIST,3:WAL)"
                     " synchronous(0:OFF,1:NORMAL,2:FULL,3:EXTRA)"
                     " messages"
-                    " g|p|b\n"
+                    " g|p|b"
+                    " [group groupUs [readAhead]]\n"
                     "\n", argv[arg_prog]);
     return (1);
   }
+  k = argc > arg_groupUs ? atoi(argv[arg_group]) : 0;
+  u = argc > arg_groupUs ? atol(argv[arg_groupUs]) : 0;
+  r = argc > arg_readAhead ? atoi(argv[arg_readAhead]) : 0;
   chanInit(realloc, free);
   sqlite3_initialize();
-  if (*argv[arg_file])
+  if (*argv[arg_file] && argc > arg_groupUs)
+    c = chanCreate(free, chanBlbStrSQLga, malloc, argv[arg_file], j, s, z, k, u * 1000, r);
+  else if (*argv[arg_file])
     c = chanCreate(free, chanBlbStrSQLa, malloc, argv[arg_file], j, s, z);
   else
     c = chanCreate(free, chanStrFIFOa, z);
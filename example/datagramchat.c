@@ -288,6 +288,7 @@ main(
   int i;
   int fd4, fd6;
   void *ctx;
+  chanBlbOpt_t o;
   pthread_t dt;
 
   ProgName = argv[0];
@@ -469,22 +470,26 @@ main(
     }
     /* opaque[] is zero (file-scope statics) -- framer threads init/fini */
     /* start chanBlb with RSEC framing for both directions */
-    if (!chanBlb(realloc, free
+    memset(&o, 0, sizeof (o));
+    o.outputv = chanBlbTrnFdDatagramOutputv;
+    if (!chanBlbOpt(realloc, free
         ,OutChan, chanBlbTrnFdDatagramOutputCtx(ctx, &fd4, fd6 >= 0 ? &fd6 : 0, fd4 >= 0 ? 1 : 0, fd6 >= 0 ? 1 : 0), chanBlbTrnFdDatagramOutput, chanBlbTrnFdDatagramOutputClose, &egrCtx, chanBlbChnRsecEgr
         ,InChan, chanBlbTrnFdDatagramInputCtx(ctx, &fd4, fd6 >= 0 ? &fd6 : 0, fd4 >= 0 ? 1 : 0, fd6 >= 0 ? 1 : 0), chanBlbTrnFdDatagramInput, chanBlbTrnFdDatagramInputClose, &igrCtx, chanBlbChnRsecIgr, 0
         ,ctx, chanBlbTrnFdDatagramFinalClose
-        ,0)) {
+        ,&o, 0)) {
       perror("chanBlb");
       return (1);
     }
   }
 #else
   /* start chanBlb for both directions */
-  if (!chanBlb(realloc, free
+  memset(&o, 0, sizeof (o));
+  o.outputv = chanBlbTrnFdDatagramOutputv;
+  if (!chanBlbOpt(realloc, free
       ,OutChan, chanBlbTrnFdDatagramOutputCtx(ctx, &fd4, fd6 >= 0 ? &fd6 : 0, fd4 >= 0 ? 1 : 0, fd6 >= 0 ? 1 : 0), chanBlbTrnFdDatagramOutput, chanBlbTrnFdDatagramOutputClose, 0, 0
       ,InChan, chanBlbTrnFdDatagramInputCtx(ctx, &fd4, fd6 >= 0 ? &fd6 : 0, fd4 >= 0 ? 1 : 0, fd6 >= 0 ? 1 : 0), chanBlbTrnFdDatagramInput, chanBlbTrnFdDatagramInputClose, 0, 0, 0
       ,ctx, chanBlbTrnFdDatagramFinalClose
-      ,0)) {
+      ,&o, 0)) {
     perror("chanBlb");
     return (1);
   }
@@ -54,6 +54,7 @@ main(
   chanBlb_t *m;
   chan_t *c[2];
   void *ctx;
+  chanBlbOpt_t o;
   int p[2];
   pthread_t t;
   int i;
@@ -82,11 +83,14 @@ main(
     chanClose(c[0]);
     return (1);
   }
-  if (!chanBlb(realloc, free
+  memset(&o, 0, sizeof (o));
+  o.outputv = chanBlbTrnFdOutputv;
+  o.egressItems = 64;
+  if (!chanBlbOpt(realloc, free
       ,c[1], chanBlbTrnFdOutputCtx(ctx, p[1]), chanBlbTrnFdOutput, chanBlbTrnFdOutputClose, 0, chanBlbChnVlqEgr
       ,c[0], chanBlbTrnFdInputCtx(ctx, p[0]), chanBlbTrnFdInput, chanBlbTrnFdInputClose, (void *)65536, chanBlbChnVlqIgr, 0
       ,ctx, chanBlbTrnFdFinalClose
-      ,0)) {
+      ,&o, 0)) {
     perror("chanPipe");
     /* contexts are destroyed by chanBlb, even on failure */
     chanClose(c[1]);
@@ -42,6 +42,7 @@ streamT(
   int s[2];        /* server and client sockets */
   void *ctx[2];    /* input and output contexts */
   chanArr_t p[2];  /* ingress and egress channels */
+  chanBlbOpt_t o;  /* bridge options */
 
   s[0] = (int)(long)v;
   if (!(ctx[0] = chanBlbTrnFdStreamCtx(realloc, free, s[0]))) {
@@ -64,28 +65,35 @@ streamT(
     perror("connect");
     goto exit1;
   }
-  if (!(p[0].c = chanCreate(free, 0))) {
+  if (!(p[0].c = chanCreate((void(*)(void*))chanBlbRefFree, 0))) {
     perror("chanCreate");
     goto exit1;
   }
-  if (!(p[1].c = chanCreate(free, 0))) {
+  if (!(p[1].c = chanCreate((void(*)(void*))chanBlbRefFree, 0))) {
     perror("chanCreate");
     chanClose(p[0].c);
     goto exit1;
   }
-  if (!chanBlb(realloc, free
+  memset(&o, 0, sizeof (o));
+  o.outputv = chanBlbTrnFdStreamOutputv;
+  o.inputAvail = chanBlbTrnFdStreamInputAvail;
+  o.egressRef = 1;
+  o.ingressRef = 1;
+  o.egressItems = 64;
+  o.ingressAdaptive = 1;
+  if (!chanBlbOpt(realloc, free
       ,p[0].c, chanBlbTrnFdStreamOutputCtx(ctx[1]), chanBlbTrnFdStreamOutput, chanBlbTrnFdStreamOutputClose, 0, 0
       ,p[1].c, chanBlbTrnFdStreamInputCtx(ctx[1]), chanBlbTrnFdStreamInput, chanBlbTrnFdStreamInputClose, 0, 0, 0
       ,ctx[1], chanBlbTrnFdStreamFinalClose
-      ,0)) {
+      ,&o, 0)) {
     perror("chanBlb");
     goto exit0;
   }
-  if (!chanBlb(realloc, free
+  if (!chanBlbOpt(realloc, free
       ,p[1].c, chanBlbTrnFdStreamOutputCtx(ctx[0]), chanBlbTrnFdStreamOutput, chanBlbTrnFdStreamOutputClose, 0, 0
       ,p[0].c, chanBlbTrnFdStreamInputCtx(ctx[0]), chanBlbTrnFdStreamInput, chanBlbTrnFdStreamInputClose, 0, 0, 0
       ,ctx[0], chanBlbTrnFdStreamFinalClose
-      ,0)) {
+      ,&o, 0)) {
     perror("chanBlb");
     return (0);
   }
@@ -109,6 +117,7 @@ datagramT(
   int s[2];        /* server and client sockets */
   void *ctx[2];    /* input and output contexts */
   chanArr_t p[2];  /* ingress and egress channels */
+  chanBlbOpt_t o;  /* bridge options */
 
   s[0] = (int)(long)v;
   if (!(ctx[0] = chanBlbTrnFdCtx(realloc, free))) {
@@ -135,32 +144,36 @@ datagramT(
     close(s[0]);
     goto exit1;
   }
-  if (!(p[0].c = chanCreate(free, 0))) {
+  if (!(p[0].c = chanCreate((void(*)(void*))chanBlbRefFree, 0))) {
     perror("chanCreate");
     close(s[1]);
     close(s[0]);
     goto exit1;
   }
-  if (!(p[1].c = chanCreate(free, 0))) {
+  if (!(p[1].c = chanCreate((void(*)(void*))chanBlbRefFree, 0))) {
     perror("chanCreate");
     chanClose(p[0].c);
     close(s[1]);
     close(s[0]);
     goto exit1;
   }
-  if (!chanBlb(realloc, free
+  memset(&o, 0, sizeof (o));
+  o.outputv = chanBlbTrnFdOutputv;
+  o.egressRef = 1;
+  o.ingressRef = 1;
+  if (!chanBlbOpt(realloc, free
       ,p[0].c, chanBlbTrnFdOutputCtx(ctx[1], s[1]), chanBlbTrnFdOutput, chanBlbTrnFdOutputClose, 0, 0
       ,p[1].c, chanBlbTrnFdInputCtx(ctx[1], s[1]), chanBlbTrnFdInput, chanBlbTrnFdInputClose, 0, 0, 0
       ,ctx[1], chanBlbTrnFdFinalClose
-      ,0)) {
+      ,&o, 0)) {
     perror("chanBlb");
     goto exit0;
   }
-  if (!chanBlb(realloc, free
+  if (!chanBlbOpt(realloc, free
       ,p[1].c, chanBlbTrnFdOutputCtx(ctx[0], s[0]), chanBlbTrnFdOutput, chanBlbTrnFdOutputClose, 0, 0
       ,p[0].c, chanBlbTrnFdInputCtx(ctx[0], s[0]), chanBlbTrnFdInput, chanBlbTrnFdInputClose, 0, 0, 0
       ,ctx[0], chanBlbTrnFdFinalClose
-      ,0)) {
+      ,&o, 0)) {
     perror("chanBlb");
     return (0);
   }
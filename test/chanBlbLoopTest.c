@@ -0,0 +1,238 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Linux bridge checks: VLQ framed items through a socketpair on a chanBlbLoop
+ * and, where io_uring is available, on chanBlb() bridges over a chanBlbTrnUring.
+ * Exits non-zero at the first failed expectation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <pthread.h>
+#include "chan.h"
+#include "chanStrFIFO.h"
+#include "chanBlb.h"
+#include "chanBlbChnVlq.h"
+#include "chanBlbLoop.h"
+#include "chanBlbTrnUring.h"
+
+#define ITEMS 100
+
+static unsigned int Finals; /* finalClose calls */
+
+static void
+final(
+  void *v
+){
+  __atomic_fetch_add(&Finals, 1, __ATOMIC_RELEASE);
+  (void)v; /* no context */
+}
+
+static void
+uringFinal(
+  void *v
+){
+  chanBlbTrnUringFinalClose(v);
+  final(v);
+}
+
+/* wait up to a second for n finalClose calls, return non-zero if they weren't */
+static int
+finals(
+  unsigned int n
+){
+  struct timespec t;
+  int i;
+
+  t.tv_sec = 0;
+  t.tv_nsec = 1000000;
+  for (i = 0; i < 1000 && __atomic_load_n(&Finals, __ATOMIC_ACQUIRE) < n; ++i)
+    nanosleep(&t, 0);
+  return (__atomic_load_n(&Finals, __ATOMIC_ACQUIRE) != n);
+}
+
+/* octets of item j */
+static unsigned int
+length(
+  unsigned int j
+){
+  return ((j * 7919) % 3000);
+}
+
+/* put ITEMS items on e and shut it, then get them from i till it is shut, return non-zero on failure */
+static int
+trip(
+  chan_t *e
+ ,chan_t *i
+){
+  chanBlb_t *b;
+  unsigned int j;
+  unsigned int k;
+
+  for (j = 0; j < ITEMS; ++j) {
+    if (!(b = malloc(chanBlb_tSize(length(j)))))
+      return (1);
+    b->l = length(j);
+    memset(b->b, j & 0xff, b->l);
+    if (chanOp(0, e, (void **)&b, chanOpPut) != chanOsPut) {
+      free(b);
+      return (1);
+    }
+  }
+  chanShut(e);
+  for (j = 0; chanOp(0, i, (void **)&b, chanOpGet) == chanOsGet; ++j) {
+    for (k = 0; k < b->l && b->b[k] == (j & 0xff); ++k);
+    k = k < b->l || b->l != length(j);
+    free(b);
+    if (k)
+      return (1);
+  }
+  return (j != ITEMS);
+}
+
+/* return a pair of non-blocking stream sockets */
+static int
+pair(
+  int *s
+){
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, s))
+    return (1);
+  fcntl(s[0], F_SETFL, fcntl(s[0], F_GETFL) | O_NONBLOCK);
+  fcntl(s[1], F_SETFL, fcntl(s[1], F_GETFL) | O_NONBLOCK);
+  return (0);
+}
+
+static int
+loop(
+  void
+){
+  chanBlbLoop_t *l;
+  chan_t *e;
+  chan_t *i;
+  int s[2];
+  int r;
+
+  if (!(l = chanBlbLoopNew(realloc, free, 1, 0)))
+    return (1);
+  e = chanCreate(free, chanStrFIFOa, ITEMS);
+  i = chanCreate(free, chanStrFIFOa, ITEMS);
+  Finals = 0;
+  r = 1;
+  if (!e || !i || pair(s))
+    goto exit;
+  if (!chanBlbLoopAdd(l, s[0], e, 0, chanBlbChnVlqLoopEgr, 0, 0, 0, 0, 0, 0, 0, final)) {
+    close(s[1]);
+    goto exit;
+  }
+  if (!chanBlbLoopAdd(l, s[1], 0, 0, 0, 0, i, 0, chanBlbChnVlqLoopIgr, 0, 0, 0, final))
+    goto exit;
+  r = trip(e, i) || finals(2);
+exit:
+  chanClose(e);
+  chanClose(i);
+  chanBlbLoopDel(l);
+  return (r);
+}
+
+/* return -1 if io_uring isn't available */
+static int
+uring(
+  void
+){
+  chanBlbTrnUring_t *u;
+  chanBlbOpt_t o;
+  chan_t *e;
+  chan_t *i;
+  void *x[2];
+  int s[2];
+  int r;
+
+  if (!(u = chanBlbTrnUringNew(realloc, free, 0, 0, 0, 0, 0)))
+    return (-1);
+  e = chanCreate(free, chanStrFIFOa, ITEMS);
+  i = chanCreate(free, chanStrFIFOa, ITEMS);
+  Finals = 0;
+  r = 1;
+  if (!e || !i || socketpair(AF_UNIX, SOCK_STREAM, 0, s))
+    goto exit;
+  if (!(x[0] = chanBlbTrnUringCtx(u))) {
+    close(s[0]);
+    close(s[1]);
+    goto exit;
+  }
+  if (!(x[1] = chanBlbTrnUringCtx(u))) {
+    chanBlbTrnUringFinalClose(x[0]);
+    close(s[0]);
+    close(s[1]);
+    goto exit;
+  }
+  memset(&o, 0, sizeof (o));
+  o.outputv = chanBlbTrnUringOutputv;
+  o.egressItems = 16;
+  if (!chanBlbOpt(realloc, free
+      ,e, chanBlbTrnUringOutputCtx(x[0], s[0]), chanBlbTrnUringOutput, chanBlbTrnUringOutputClose, 0, chanBlbChnVlqEgr
+      ,0, 0, 0, 0, 0, 0, 0
+      ,x[0], uringFinal
+      ,&o, 0)) {
+    chanBlbTrnUringFinalClose(x[1]);
+    close(s[1]);
+    goto exit;
+  }
+  if (!chanBlb(realloc, free
+      ,0, 0, 0, 0, 0, 0
+      ,i, chanBlbTrnUringInputCtx(x[1], s[1], 0), chanBlbTrnUringInput, chanBlbTrnUringInputClose, 0, chanBlbChnVlqIgr, 0
+      ,x[1], uringFinal
+      ,0))
+    goto exit;
+  r = trip(e, i) || finals(2);
+exit:
+  chanClose(e);
+  chanClose(i);
+  if (!r)
+    chanBlbTrnUringDel(u);
+  return (r);
+}
+
+int
+main(
+  void
+){
+  signal(SIGPIPE, SIG_IGN);
+  chanInit(realloc, free);
+  if (loop())
+    return (1);
+  switch (uring()) {
+  case -1:
+    fprintf(stderr, "chanBlbLoopTest: io_uring unavailable, chanBlbTrnUring skipped\n");
+    break;
+  case 0:
+    break;
+  default:
+    return (2);
+  }
+  return (0);
+}
@@ -0,0 +1,142 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * chanBlb_t allocation benchmark: libc realloc/free versus chanBlbSlb.
+ *
+ * Each pair is an ingress-like producer thread that allocates a 64KiB blob,
+ * shrinks it to a message size and Puts it on a FIFO Channel,
+ * and an egress-like consumer thread that Gets, reads and frees it.
+ *
+ * For jemalloc, preload it into the libc run:
+ *  LD_PRELOAD=libjemalloc.so.2 ./chanBlbSlbBench libc 4 1000000
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "chan.h"
+#include "chanStrFIFO.h"
+#include "chanBlb.h"
+#include "chanBlbSlb.h"
+
+static void *(*Ma)(void *, unsigned long);
+static void (*Mf)(void *);
+static unsigned long Msgs;
+
+static void *
+prdT(
+  void *v
+){
+  chanBlb_t *m;
+  void *t;
+  unsigned long i;
+  unsigned int r;
+
+  r = (unsigned long)v;
+  for (i = 0; i < Msgs; ++i) {
+    if (!(m = Ma(0, chanBlb_tSize(65536))))
+      break;
+    r = r * 1103515245 + 12345;
+    m->l = 16 + (r >> 16) % 2048;
+    m->b[0] = i;
+    m->b[m->l - 1] = i;
+    if ((t = Ma(m, chanBlb_tSize(m->l))))
+      m = t;
+    if (chanOp(0, v, (void **)&m, chanOpPut) != chanOsPut) {
+      Mf(m);
+      break;
+    }
+  }
+  chanShut(v);
+  return (0);
+}
+
+static void *
+cnsT(
+  void *v
+){
+  chanBlb_t *m;
+  unsigned long s;
+
+  s = 0;
+  while (chanOp(0, v, (void **)&m, chanOpGet) == chanOsGet) {
+    s += m->b[0] + m->b[m->l - 1];
+    Mf(m);
+  }
+  return ((void *)s);
+}
+
+int
+main(
+  int argc
+ ,char **argv
+){
+  chan_t **c;
+  pthread_t *t;
+  struct timespec b;
+  struct timespec e;
+  unsigned int n;
+  unsigned int i;
+  double d;
+
+  if (argc != 4
+   || !(n = strtoul(argv[2], 0, 0))
+   || !(Msgs = strtoul(argv[3], 0, 0))) {
+    fprintf(stderr, "Usage: %s libc|slab pairs messages\n", argv[0]);
+    return (1);
+  }
+  if (*argv[1] == 's') {
+    Ma = chanBlbSlbRealloc;
+    Mf = chanBlbSlbFree;
+  } else {
+    Ma = (void *(*)(void *, unsigned long))realloc;
+    Mf = free;
+  }
+  chanInit(Ma, Mf);
+  if (!(c = malloc(n * sizeof (*c)))
+   || !(t = malloc(2 * n * sizeof (*t)))) {
+    perror("malloc");
+    return (1);
+  }
+  for (i = 0; i < n; ++i)
+    if (!(c[i] = chanCreate(Mf, chanStrFIFOa, 64))) {
+      perror("chanCreate");
+      return (1);
+    }
+  clock_gettime(CLOCK_MONOTONIC, &b);
+  for (i = 0; i < n; ++i)
+    if (pthread_create(&t[2 * i], 0, cnsT, c[i])
+     || pthread_create(&t[2 * i + 1], 0, prdT, c[i])) {
+      perror("pthread_create");
+      return (1);
+    }
+  for (i = 0; i < 2 * n; ++i)
+    pthread_join(t[i], 0);
+  clock_gettime(CLOCK_MONOTONIC, &e);
+  d = (e.tv_sec - b.tv_sec) + (e.tv_nsec - b.tv_nsec) / 1e9;
+  printf("%s %u pairs %lu messages %.3fs %.0f msg/s\n", argv[1], n, n * Msgs, d, n * Msgs / d);
+  for (i = 0; i < n; ++i)
+    chanClose(c[i]);
+  free(t);
+  free(c);
+  return (0);
+}
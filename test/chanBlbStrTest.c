@@ -0,0 +1,212 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * chanBlb_t Store behavior checks, in a temporary directory.
+ * Exits non-zero at the first failed expectation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/wait.h>
+#include <pthread.h>
+#include "chan.h"
+#include "chanBlb.h"
+#include "chanBlbStrSPL.h"
+#include "chanBlbStrLOG.h"
+
+/* octets of a LOG record: length, CRC-32 and octets */
+#define REC(l) (2 * sizeof (unsigned int) + (l))
+
+/* put a blob of l octets of i, return non-zero unless chanOp returns s */
+static int
+put(
+  chan_t *c
+ ,unsigned int i
+ ,unsigned int l
+ ,chanOs_t s
+){
+  chanBlb_t *b;
+  chanOs_t r;
+
+  if (!(b = malloc(chanBlb_tSize(l))))
+    return (1);
+  b->l = l;
+  memset(b->b, i & 0xff, l);
+  if ((r = chanOp(-1, c, (void **)&b, chanOpPut)) != chanOsPut)
+    free(b);
+  return (r != s);
+}
+
+/* get a blob, return non-zero unless it is l octets of i */
+static int
+get(
+  chan_t *c
+ ,unsigned int i
+ ,unsigned int l
+){
+  chanBlb_t *b;
+  unsigned int j;
+  int r;
+
+  if (chanOp(-1, c, (void **)&b, chanOpGet) != chanOsGet)
+    return (1);
+  for (r = b->l != l, j = 0; !r && j < l; ++j)
+    r = b->b[j] != (i & 0xff);
+  free(b);
+  return (r);
+}
+
+/* return the number of entries, other than . and .., in a directory, removing them if u */
+static int
+entries(
+  const char *p
+ ,int u
+){
+  char f[256];
+  DIR *d;
+  struct dirent *e;
+  int n;
+
+  if (!(d = opendir(p)))
+    return (-1);
+  for (n = 0; (e = readdir(d));)
+    if (strcmp(e->d_name, ".") && strcmp(e->d_name, "..")) {
+      ++n;
+      if (u) {
+        snprintf(f, sizeof (f), "%s/%s", p, e->d_name);
+        unlink(f);
+      }
+    }
+  closedir(d);
+  return (n);
+}
+
+/* items spill past memory, in order, a record larger than a segment included, up to size */
+static int
+spl(
+  const char *p
+){
+  chan_t *c;
+  unsigned int i;
+
+  if (!(c = chanCreate(free, chanBlbStrSPLa, malloc, p, 2U, 4096UL, 100UL)))
+    return (1);
+  for (i = 0; i < 100; ++i)
+    if (put(c, i, i == 50 ? 10000 : 100, chanOsPut))
+      goto fail;
+  if (put(c, 100, 100, chanOsTmo))
+    goto fail;
+  for (i = 0; i < 60; ++i)
+    if (get(c, i, i == 50 ? 10000 : 100))
+      goto fail;
+  for (i = 100; i < 160; ++i)
+    if (put(c, i, 100, chanOsPut))
+      goto fail;
+  if (put(c, 160, 100, chanOsTmo))
+    goto fail;
+  for (i = 60; i < 160; ++i)
+    if (get(c, i, 100))
+      goto fail;
+  if (!get(c, 0, 0))
+    goto fail;
+  chanClose(c);
+  return (entries(p, 0) != 0);
+fail:
+  chanClose(c);
+  return (1);
+}
+
+/* after a crash past a sync and a torn last record, recovery keeps the synced and whole records */
+static int
+logged(
+  const char *p
+){
+  char f[256];
+  chan_t *c;
+  unsigned int i;
+  pid_t k;
+  int s;
+
+  /* crash: Puts and Gets since the last sync (every 5), without a deallocation */
+  if ((k = fork()) < 0)
+    return (1);
+  if (!k) {
+    if (!(c = chanCreate(free, chanBlbStrLOGa, malloc, p, 4096UL, 100UL, 5U, 0UL)))
+      _exit(1);
+    for (i = 0; i < 12; ++i)
+      if (put(c, i, 6, chanOsPut))
+        _exit(1);
+    for (i = 0; i < 2; ++i)
+      if (get(c, i, 6))
+        _exit(1);
+    _exit(0);
+  }
+  if (waitpid(k, &s, 0) != k || !WIFEXITED(s) || WEXITSTATUS(s))
+    return (1);
+  /* tear the last record */
+  snprintf(f, sizeof (f), "%s/%016llx.log", p, 0ULL);
+  if (truncate(f, 11 * REC(6) + REC(2)))
+    return (1);
+  /* the two Gets are got again, the record past the sync is kept, the torn one isn't */
+  if (!(c = chanCreate(free, chanBlbStrLOGa, malloc, p, 4096UL, 100UL, 5U, 0UL)))
+    return (1);
+  for (i = 0; i < 11; ++i)
+    if (get(c, i, 6))
+      goto fail;
+  if (!get(c, 0, 0)
+   || put(c, 11, 6, chanOsPut)
+   || get(c, 11, 6))
+    goto fail;
+  chanClose(c);
+  /* and a clean reopen finds it empty */
+  if (!(c = chanCreate(free, chanBlbStrLOGa, malloc, p, 4096UL, 100UL, 5U, 0UL)))
+    return (1);
+  if (!get(c, 0, 0))
+    goto fail;
+  chanClose(c);
+  return (0);
+fail:
+  chanClose(c);
+  return (1);
+}
+
+int
+main(
+  void
+){
+  char p[] = "/tmp/chanBlbStrTestXXXXXX";
+  int r;
+
+  chanInit(realloc, free);
+  if (!mkdtemp(p))
+    return (1);
+  r = 0;
+  if (spl(p))
+    r = 2;
+  else if (logged(p))
+    r = 3;
+  entries(p, 1);
+  rmdir(p);
+  return (r);
+}
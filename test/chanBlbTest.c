@@ -0,0 +1,208 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * chanBlb() bridge checks, with chanBlb.c built for a FINGRACE of 1 second.
+ * Exits non-zero at the first failed expectation.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <pthread.h>
+#include "chan.h"
+#include "chanStrFIFO.h"
+#include "chanBlb.h"
+#include "chanBlbTrnFd.h"
+
+#define SMALL 200 /* short datagrams before a long one */
+
+static unsigned int Finals; /* finalClose calls */
+
+static void
+final(
+  void *v
+){
+  chanBlbTrnFdFinalClose(v);
+  __atomic_fetch_add(&Finals, 1, __ATOMIC_RELEASE);
+}
+
+/* wait up to s tenths of a second for a finalClose call, return non-zero if there wasn't one */
+static int
+finals(
+  int s
+){
+  struct timespec t;
+  int i;
+
+  t.tv_sec = 0;
+  t.tv_nsec = 10000000;
+  for (i = 0; i < s * 10 && !__atomic_load_n(&Finals, __ATOMIC_ACQUIRE); ++i)
+    nanosleep(&t, 0);
+  return (!__atomic_load_n(&Finals, __ATOMIC_ACQUIRE));
+}
+
+/* get an item, return its length or -1 on failure */
+static long
+got(
+  chan_t *c
+ ,int r
+){
+  void *v;
+  long l;
+
+  if (chanOp(0, c, &v, chanOpGet) != chanOsGet)
+    return (-1);
+  if (r) {
+    l = ((chanBlbRef_t *)v)->l;
+    chanBlbRefFree(v);
+  } else {
+    l = ((chanBlb_t *)v)->l;
+    free(v);
+  }
+  return (l);
+}
+
+/* a long datagram after many short ones is one whole item, as chanBlbRef_t items if r */
+static int
+datagram(
+  int r
+){
+  unsigned char b[3000];
+  chanBlbOpt_t o;
+  chan_t *c;
+  void *x;
+  int s[2];
+  int i;
+
+  if (!(c = chanCreate(0, chanStrFIFOa, SMALL + 1)))
+    return (1);
+  if (socketpair(AF_UNIX, SOCK_DGRAM, 0, s)
+   || !(x = chanBlbTrnFdCtx(realloc, free))) {
+    chanClose(c);
+    return (1);
+  }
+  memset(&o, 0, sizeof (o));
+  o.ingressRef = r;
+  if (!chanBlbOpt(realloc, free
+      ,0, 0, 0, 0, 0, 0
+      ,c, chanBlbTrnFdInputCtx(x, s[1]), chanBlbTrnFdInput, chanBlbTrnFdInputClose, 0, 0, 0
+      ,x, chanBlbTrnFdFinalClose
+      ,&o, 0)) {
+    close(s[0]);
+    chanClose(c);
+    return (1);
+  }
+  memset(b, 1, sizeof (b));
+  for (i = 0; i < SMALL; ++i)
+    if (send(s[0], b, 10, 0) != 10)
+      goto fail;
+  for (i = 0; i < SMALL; ++i)
+    if (got(c, r) != 10)
+      goto fail;
+  if (send(s[0], b, sizeof (b), 0) != sizeof (b)
+   || got(c, r) != sizeof (b))
+    goto fail;
+  /* an empty datagram reads as an end */
+  i = send(s[0], b, 0, 0) != 0 || got(c, r) != -1;
+  close(s[0]);
+  chanClose(c);
+  return (i);
+fail:
+  close(s[0]);
+  chanClose(c);
+  return (1);
+}
+
+/* a lone direction blocked after its Channel is shut is cancelled after the grace, an egress if e else an ingress */
+static int
+lone(
+  int e
+){
+  chanBlb_t *b;
+  chan_t *c;
+  void *x;
+  int s[2];
+  int i;
+
+  if (!(c = chanCreate(free, chanStrFIFOa, 4)))
+    return (1);
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, s)
+   || !(x = chanBlbTrnFdCtx(realloc, free))) {
+    chanClose(c);
+    return (1);
+  }
+  Finals = 0;
+  if (e ? !chanBlb(realloc, free
+      ,c, chanBlbTrnFdOutputCtx(x, s[1]), chanBlbTrnFdOutput, chanBlbTrnFdOutputClose, 0, 0
+      ,0, 0, 0, 0, 0, 0, 0
+      ,x, final
+      ,0)
+        : !chanBlb(realloc, free
+      ,0, 0, 0, 0, 0, 0
+      ,c, chanBlbTrnFdInputCtx(x, s[1]), chanBlbTrnFdInput, chanBlbTrnFdInputClose, 0, 0, 0
+      ,x, final
+      ,0)) {
+    close(s[0]);
+    chanClose(c);
+    return (1);
+  }
+  /* the peer doesn't read, so output() blocks once the socket buffer is full */
+  for (i = 0; e && i < 2; ++i) {
+    if (!(b = malloc(chanBlb_tSize(1 << 24))))
+      goto fail;
+    b->l = 1 << 24;
+    memset(b->b, 0, b->l);
+    if (chanOp(0, c, (void **)&b, chanOpPut) != chanOsPut) {
+      free(b);
+      goto fail;
+    }
+  }
+  chanShut(c);
+  if (!finals(2) || finals(40))
+    goto fail;
+  close(s[0]);
+  chanClose(c);
+  return (0);
+fail:
+  close(s[0]);
+  chanClose(c);
+  return (1);
+}
+
+int
+main(
+  void
+){
+  signal(SIGPIPE, SIG_IGN);
+  chanInit(realloc, free);
+  if (datagram(0))
+    return (1);
+  if (datagram(1))
+    return (2);
+  if (lone(0))
+    return (3);
+  if (lone(1))
+    return (4);
+  return (0);
+}
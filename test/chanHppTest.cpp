@@ -0,0 +1,104 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * chan.hpp exercise: inline, pointer, unique_ptr and boxed items, select() and all().
+ * Exits non-zero at the first failed expectation.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "chan.hpp"
+
+struct Ev {
+  int a;
+  double b;
+};
+
+int
+main(
+  void
+){
+  chanInit((void *(*)(void *, unsigned long))realloc, free);
+
+  /* inline */
+  chn::Channel<Ev> e(4);
+  Ev x{1, 2.5};
+  Ev y{};
+  if (e.put(x) != chanOsPut || e.put(Ev{2, 3.5}) != chanOsPut
+   || e.get(y) != chanOsGet || y.a != 1)
+    return (1);
+
+  /* unique_ptr, ownership leaves only on a Put */
+  chn::Channel<std::unique_ptr<std::string>> u(2);
+  auto s1 = std::make_unique<std::string>("one");
+  auto s2 = std::make_unique<std::string>("two");
+  auto s3 = std::make_unique<std::string>("three");
+  std::unique_ptr<std::string> g;
+  if (u.put(s1) != chanOsPut || s1
+   || u.put(s2) != chanOsPut
+   || u.put(s3, -1) == chanOsPut || !s3
+   || u.get(g) != chanOsGet || *g != "one")
+    return (2);
+
+  /* boxed, between threads */
+  chn::Channel<std::string> b;
+  std::string m = "boxed";
+  std::string r;
+  std::thread t([b, &r]() mutable { b.get(r); });
+  if (b.put(m) != chanOsPut)
+    return (3);
+  t.join();
+  if (r != "boxed")
+    return (3);
+
+  /* an abandoned put operation gives the item back */
+  std::string k = "kept";
+  {
+    auto o = b.putOp(k);
+  }
+  if (k != "kept")
+    return (4);
+
+  /* select */
+  chn::Channel<int> i1(1);
+  chn::Channel<int> i2(1);
+  int v1 = 0;
+  int v2 = 0;
+  i2.put(7);
+  auto o = chn::select(0, i1.getOp(v1), i2.getOp(v2));
+  if (o.index != 2 || o.status != chanOsGet || v2 != 7)
+    return (5);
+
+  /* select of Puts, the one not done keeps its item */
+  chn::Channel<std::unique_ptr<std::string>> u2(1);
+  o = chn::select(-1, u.putOp(s3), u2.putOp(g));
+  if (o.index != 1 || o.status != chanOsPut || s3 || !g)
+    return (6);
+
+  /* all */
+  auto p1 = i1.putOp(v1);
+  auto p2 = i2.putOp(v2);
+  if (chn::all(0, p1, p2) != chanAlOp || p1.status() != chanOsPut || p2.status() != chanOsPut)
+    return (7);
+  return (0);
+}
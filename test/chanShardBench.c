@@ -0,0 +1,150 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Sharded Channel benchmark: many producers Putting into one FIFO Channel
+ * versus one FIFO Channel per shard (per CPU). The consumer drains a shard
+ * till it is empty, then moves on round-robin, waiting on all with chanOne.
+ *
+ * Every Store operation runs under its Channel's lock, so sharding is done
+ * with Channels, not inside a Store. Order is kept per shard (per producer) only.
+ *
+ *  ./chanShardBench 1000000 1 2 4 8 16 32 64
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "chan.h"
+#include "chanStrFIFO.h"
+
+static unsigned long Items;
+
+struct prd {
+  chan_t *c;
+  unsigned long n;
+};
+
+static void *
+prdT(
+  void *v
+){
+  void *i;
+  unsigned long j;
+
+  for (j = 0; j < ((struct prd *)v)->n; ++j) {
+    i = (void *)(j + 1);
+    if (chanOp(0, ((struct prd *)v)->c, &i, chanOpPut) != chanOsPut)
+      break;
+  }
+  return (0);
+}
+
+static double
+run(
+  unsigned int p
+ ,unsigned int s
+){
+  struct timespec b;
+  struct timespec e;
+  pthread_t *t;
+  struct prd *d;
+  chan_t **c;
+  chanArr_t *a;
+  void *i;
+  unsigned long n;
+  unsigned int j;
+  unsigned int r;
+
+  t = malloc(p * sizeof (*t));
+  d = malloc(p * sizeof (*d));
+  c = malloc(s * sizeof (*c));
+  a = malloc(s * sizeof (*a));
+  for (j = 0; j < s; ++j)
+    c[j] = chanCreate(0, chanStrFIFOa, 1024);
+  clock_gettime(CLOCK_MONOTONIC, &b);
+  for (j = 0; j < p; ++j) {
+    d[j].c = c[j % s];
+    d[j].n = Items / p + (j < Items % p);
+    pthread_create(t + j, 0, prdT, d + j);
+  }
+  if (s == 1)
+    for (n = 0; n < Items && chanOp(0, c[0], &i, chanOpGet) == chanOsGet; ++n);
+  else
+    for (n = r = 0; n < Items; ++n) {
+      if (chanOp(-1, c[r], &i, chanOpGet) == chanOsGet)
+        continue;
+      r = (r + 1) % s;
+      /* wait on all, rotating the array so no shard starves */
+      for (j = 0; j < s; ++j) {
+        a[j].c = c[(r + j) % s];
+        a[j].v = &i;
+        a[j].o = chanOpGet;
+      }
+      if (!(j = chanOne(0, s, a)) || a[j - 1].s != chanOsGet)
+        break;
+      r = (r + j - 1) % s;
+    }
+  clock_gettime(CLOCK_MONOTONIC, &e);
+  for (j = 0; j < p; ++j)
+    pthread_join(t[j], 0);
+  for (j = 0; j < s; ++j)
+    chanClose(c[j]);
+  free(a);
+  free(c);
+  free(d);
+  free(t);
+  return ((e.tv_sec - b.tv_sec) + (e.tv_nsec - b.tv_nsec) / 1e9);
+}
+
+int
+main(
+  int argc
+ ,char **argv
+){
+  unsigned int p;
+  unsigned int s;
+  long u;
+  int a;
+  double d;
+
+  if (argc < 3
+   || !(Items = strtoul(argv[1], 0, 0))) {
+    fprintf(stderr, "Usage: %s items producers ...\n", argv[0]);
+    return (1);
+  }
+  chanInit((void *(*)(void *, unsigned long))realloc, free);
+  if ((u = sysconf(_SC_NPROCESSORS_ONLN)) < 1)
+    u = 1;
+  for (a = 2; a < argc; ++a) {
+    if (!(p = strtoul(argv[a], 0, 0)))
+      continue;
+    d = run(p, 1);
+    printf("producers %2u one              %.3fs %.1f Mitems/s\n", p, d, Items / d / 1e6);
+    s = p < u ? p : u;
+    if (s < 2)
+      s = 2;
+    d = run(p, s);
+    printf("producers %2u shards %-3u        %.3fs %.1f Mitems/s\n", p, s, d, Items / d / 1e6);
+  }
+  return (0);
+}
@@ -0,0 +1,124 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2024 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Store benchmark: fill a Channel to capacity and drain it, repeatedly,
+ * reporting the cost of a Put and Get pair through each Store.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "chan.h"
+#include "chanStrFIFO.h"
+#include "chanStrPQ.h"
+#include "chanStrDLY.h"
+#include "chanStrSEG.h"
+#include "chanStrFIFOm.h"
+
+CHANSTRFIFOM(fifom, 1024)
+
+static int
+cmp(
+  void *a
+ ,void *b
+){
+  return (((unsigned long)a & 7) - ((unsigned long)b & 7));
+}
+
+/* released on Put */
+static void
+rls(
+  void *v
+ ,struct timespec *t
+){
+  t->tv_sec = 0;
+  t->tv_nsec = 0;
+  (void)v;
+}
+
+static chan_t *
+create(
+  const char *s
+ ,unsigned int n
+){
+  if (!strcmp(s, "fifo"))
+    return (chanCreate(0, chanStrFIFOa, n));
+  if (!strcmp(s, "pq"))
+    return (chanCreate(0, chanStrPQa, n, cmp));
+  if (!strcmp(s, "dly"))
+    return (chanCreate(0, chanStrDLYa, n, rls));
+  if (!strcmp(s, "seg"))
+    return (chanCreate(0, chanStrSEGa, n, 64));
+  if (!strcmp(s, "fifom") && n == 1024)
+    return (chanCreate(0, fifoma));
+  return (0);
+}
+
+int
+main(
+  int argc
+ ,char **argv
+){
+  chan_t *c;
+  struct timespec b;
+  struct timespec e;
+  unsigned long r;
+  unsigned long i;
+  unsigned long k;
+  unsigned int n;
+  unsigned int j;
+  int a;
+  double d;
+
+  if (argc < 4
+   || !(n = strtoul(argv[1], 0, 0))
+   || !(r = strtoul(argv[2], 0, 0))) {
+    fprintf(stderr, "Usage: %s capacity rounds store ...\n", argv[0]);
+    fprintf(stderr, " store: fifo pq dly seg fifom (capacity 1024)\n");
+    return (1);
+  }
+  chanInit((void *(*)(void *, unsigned long))realloc, free);
+  for (a = 3; a < argc; ++a) {
+    if (!(c = create(argv[a], n))) {
+      fprintf(stderr, "%s: can't create\n", argv[a]);
+      return (1);
+    }
+    k = 0;
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    for (i = 0; i < r; ++i) {
+      void *v;
+
+      for (j = 0; j < n; ++j) {
+        v = (void *)(k++ * 2654435761UL);
+        if (chanOp(-1, c, &v, chanOpPut) != chanOsPut)
+          break;
+      }
+      while (chanOp(-1, c, &v, chanOpGet) == chanOsGet);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &e);
+    d = (e.tv_sec - b.tv_sec) + (e.tv_nsec - b.tv_nsec) / 1e9;
+    printf("%-8s capacity %u items %lu %.3fs %.1f ns/item\n", argv[a], n, k, d, d * 1e9 / k);
+    chanClose(c);
+  }
+  return (0);
+}
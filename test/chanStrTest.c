@@ -0,0 +1,311 @@
+/*
+ * pthreadChannel - an implementation of channels for pthreads
+ * Copyright (C) 2016-2025 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of pthreadChannel
+ *
+ * pthreadChannel is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * pthreadChannel is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Store behavior checks.
+ * Exits non-zero at the first failed expectation.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "chan.h"
+#include "chanStrRATE.h"
+#include "chanStrCODEL.h"
+#include "chanStrFLT.h"
+#include "chanStrKEY.h"
+
+static unsigned int Dealloc; /* items deallocated */
+static unsigned int Marked;  /* items marked */
+
+static void
+dealloc(
+  void *v
+){
+  ++Dealloc;
+  (void)v; /* not allocated */
+}
+
+static void
+mark(
+  void *v
+){
+  ++Marked;
+  (void)v; /* not needed */
+}
+
+static void
+nap(
+  long ms
+){
+  struct timespec t;
+
+  t.tv_sec = 0;
+  t.tv_nsec = ms * 1000000;
+  nanosleep(&t, 0);
+}
+
+static unsigned long long
+now(
+  void
+){
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (t.tv_sec * 1000000000ULL + t.tv_nsec);
+}
+
+/* a burst is got at once, then Gets are paced to the rate */
+static int
+rate(
+  void
+){
+  chan_t *c;
+  void *v;
+  unsigned long long t;
+  long i;
+
+  if (!(c = chanCreate(0, chanStrRATEa, 16, 100UL, 2UL, (unsigned long (*)(void *))0)))
+    return (1);
+  for (i = 1; i <= 5; ++i) {
+    v = (void *)i;
+    if (chanOp(-1, c, &v, chanOpPut) != chanOsPut)
+      goto fail;
+  }
+  for (i = 1; i <= 2; ++i)
+    if (chanOp(-1, c, &v, chanOpGet) != chanOsGet || (long)v != i)
+      goto fail;
+  if (chanOp(-1, c, &v, chanOpGet) == chanOsGet)
+    goto fail;
+  t = now();
+  for (i = 3; i <= 5; ++i)
+    if (chanOp(0, c, &v, chanOpGet) != chanOsGet || (long)v != i)
+      goto fail;
+  if ((t = now() - t) < 20000000ULL || t > 1000000000ULL)
+    goto fail;
+  chanClose(c);
+  return (0);
+fail:
+  chanClose(c);
+  return (1);
+}
+
+/* a standing queue is dropped down to its last item after an interval, or only marked with mark */
+static int
+codel(
+  void (*m)(void *)
+){
+  chanStrCODELs_t z;
+  chan_t *c;
+  void *v;
+  long i;
+  long l;
+
+  memset(&z, 0, sizeof (z));
+  Dealloc = Marked = 0;
+  if (!(c = chanCreate(dealloc, chanStrCODELa, 16, 1000000UL, 10000000UL, m, &z)))
+    return (1);
+  for (i = 1; i <= 10; ++i) {
+    v = (void *)i;
+    if (chanOp(-1, c, &v, chanOpPut) != chanOsPut)
+      goto fail;
+  }
+  nap(20);
+  if (chanOp(-1, c, &v, chanOpGet) != chanOsGet || (long)v != 1)
+    goto fail;
+  nap(15);
+  for (i = 0, l = 0; chanOp(-1, c, &v, chanOpGet) == chanOsGet; ++i)
+    l = (long)v;
+  if (l != 10
+   || z.put != 10 || z.put != z.get + z.drop
+   || z.drop != Dealloc || z.mark != Marked
+   || (m ? z.drop || i != 9 || !z.mark : !z.drop || i != 9 - (long)z.drop)
+   || chanStrCODELpct(&z, 100) < 16000000ULL)
+    goto fail;
+  chanClose(c);
+  return (0);
+fail:
+  chanClose(c);
+  return (1);
+}
+
+/* put i items then see that the next is refused, return non-zero on failure */
+static int
+fill(
+  chan_t *c
+ ,long i
+){
+  void *v;
+
+  for (; i; --i) {
+    v = (void *)i;
+    if (chanOp(-1, c, &v, chanOpPut) != chanOsPut)
+      return (1);
+  }
+  v = (void *)1;
+  return (chanOp(-1, c, &v, chanOpPut) == chanOsPut);
+}
+
+/* size limits Puts, grows to what drains within target and shrinks when Gets slow */
+static int
+flt(
+  void
+){
+  chanStrFLTs_t z;
+  chan_t *c;
+  void *v;
+  long i;
+
+  if (!(c = chanCreate(0, chanStrFLTa, 64, 4, 1000000000UL, 1, &z)))
+    return (1);
+  if (fill(c, 4))
+    goto fail;
+  for (i = 4; i > 2; --i)
+    if (chanOp(-1, c, &v, chanOpGet) != chanOsGet || (long)v != i)
+      goto fail;
+  if (z.size != 64 || !z.grow || z.shrink
+   || fill(c, 62))
+    goto fail;
+  chanClose(c);
+  if (!(c = chanCreate(0, chanStrFLTa, 64, 4, 1000000UL, 1, &z)))
+    return (1);
+  if (fill(c, 4))
+    goto fail;
+  for (i = 4; i; --i) {
+    nap(10);
+    if (chanOp(-1, c, &v, chanOpGet) != chanOsGet || (long)v != i)
+      goto fail;
+  }
+  if (z.size != 1 || z.grow || !z.shrink
+   || z.sojourn < 10000000UL || z.interval < 5000000UL
+   || fill(c, 1))
+    goto fail;
+  chanClose(c);
+  return (0);
+fail:
+  chanClose(c);
+  return (1);
+}
+
+struct kv {
+  unsigned char k[2]; /* key */
+  long v;             /* value */
+};
+
+static const void *
+key(
+  void *v
+ ,unsigned int *l
+){
+  *l = sizeof (((struct kv *)v)->k);
+  return (((struct kv *)v)->k);
+}
+
+/* get an item, return non-zero unless it has key k and value v */
+static int
+got(
+  chan_t *c
+ ,unsigned int k
+ ,long v
+){
+  void *i;
+
+  return (chanOp(-1, c, &i, chanOpGet) != chanOsGet
+   || ((struct kv *)i)->k[0] != (k & 0xff) || ((struct kv *)i)->k[1] != k >> 8
+   || ((struct kv *)i)->v != v);
+}
+
+/* a Put of a queued key replaces its item in place, size bounds the keys */
+static int
+keyed(
+  void
+){
+  static struct kv q[8 + 800];
+  chan_t *c;
+  void *v;
+  unsigned int i;
+  unsigned int j;
+
+  for (i = 0; i < sizeof (q) / sizeof (q[0]); ++i) {
+    q[i].k[0] = i < 8 ? "abacabdb"[i] : (i - 8) & 0xff;
+    q[i].k[1] = i < 8 ? 0 : (i - 8) >> 8;
+    q[i].v = i;
+  }
+  Dealloc = 0;
+  if (!(c = chanCreate(dealloc, chanStrKEYa, 3, key)))
+    return (1);
+  for (i = 0; i < 4; ++i) {
+    v = &q[i];
+    if (chanOp(-1, c, &v, chanOpPut) != chanOsPut)
+      goto fail;
+  }
+  v = &q[4];
+  if (chanOp(-1, c, &v, chanOpPut) == chanOsPut
+   || Dealloc != 1
+   || got(c, 'a', 2) || got(c, 'b', 1))
+    goto fail;
+  for (i = 4; i < 6; ++i) {
+    v = &q[i];
+    if (chanOp(-1, c, &v, chanOpPut) != chanOsPut)
+      goto fail;
+  }
+  if (got(c, 'c', 3) || got(c, 'a', 4) || got(c, 'b', 5)
+   || chanOp(-1, c, &v, chanOpGet) == chanOsGet)
+    goto fail;
+  chanClose(c);
+  if (!(c = chanCreate(dealloc, chanStrKEYa, 16, key)))
+    return (1);
+  for (i = 8; i + 16 <= sizeof (q) / sizeof (q[0]); i += 11) {
+    for (j = 0; j < 16; ++j) {
+      v = &q[i + j];
+      if (chanOp(-1, c, &v, chanOpPut) != chanOsPut)
+        goto fail;
+    }
+    for (j = 0; j < 16; ++j)
+      if (got(c, i - 8 + j, i + j))
+        goto fail;
+  }
+  if (Dealloc != 1)
+    goto fail;
+  chanClose(c);
+  return (0);
+fail:
+  chanClose(c);
+  return (1);
+}
+
+int
+main(
+  void
+){
+  chanInit(realloc, free);
+  if (rate())
+    return (1);
+  if (codel(0))
+    return (2);
+  if (codel(mark))
+    return (3);
+  if (flt())
+    return (4);
+  if (keyed())
+    return (5);
+  return (0);
+}
@@ -529,6 +529,7 @@ setup(
  ,struct rsecPair *rsecCtx
 ){
   void *dgramCtx;
+  chanBlbOpt_t o;
   socklen_t sl;
   int one;
   int bufsz;
@@ -586,11 +587,13 @@ setup(
     return (0);
   }
 
-  if (!chanBlb(realloc, free
+  memset(&o, 0, sizeof (o));
+  o.outputv = chanBlbTrnFdDatagramOutputv;
+  if (!chanBlbOpt(realloc, free
       ,env->outChan, chanBlbTrnFdDatagramOutputCtx(dgramCtx, &env->fd, 0, 1, 0), chanBlbTrnFdDatagramOutput, chanBlbTrnFdDatagramOutputClose, &rsecCtx->egr, chanBlbChnRsecEgr
       ,env->inChan, chanBlbTrnFdDatagramInputCtx(dgramCtx, &env->fd, 0, 1, 0), chanBlbTrnFdDatagramInput, chanBlbTrnFdDatagramInputClose, &rsecCtx->igr, chanBlbChnRsecIgr, 0
       ,dgramCtx, chanBlbTrnFdDatagramFinalClose
-      ,0)) {
+      ,&o, 0)) {
     close(env->fd);
     return (0);
   }